@@ -0,0 +1,42 @@
+/*
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+    Lorenzo Miori (C) 2016 [ 3M4|L: memoryS60<at>gmail.com ]
+
+    Version History
+        * 1.0 initial
+
+*/
+
+/**
+ * @file interrupt.h
+ * @author Lorenzo Miori
+ * @date Oct 2016
+ * @brief Host simulation: interrupt handlers are plain functions, run by
+ *        the simulation (see sim_io.c) while the I bit of SREG is set.
+ */
+
+#ifndef SIM_AVR_INTERRUPT_H_
+#define SIM_AVR_INTERRUPT_H_
+
+#include "io.h"
+
+#define ISR(vector, ...)    void vector(void); void vector(void)
+
+#define sei()   sim_sei()
+#define cli()   (SREG &= (uint8_t)~(1U << SREG_I))
+
+void sim_sei(void);
+
+#endif /* SIM_AVR_INTERRUPT_H_ */
@@ -0,0 +1,177 @@
+/*
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+    Lorenzo Miori (C) 2016 [ 3M4|L: memoryS60<at>gmail.com ]
+
+    Version History
+        * 1.0 initial
+
+*/
+
+/**
+ * @file io.h
+ * @author Lorenzo Miori
+ * @date Oct 2016
+ * @brief Host simulation: the ATmega8 registers used by the firmware,
+ *        as plain variables (see sim_io.c). The ADC, Timer0 and the
+ *        key inputs are driven by the simulation, the rest only
+ *        holds what the firmware writes.
+ */
+
+#ifndef SIM_AVR_IO_H_
+#define SIM_AVR_IO_H_
+
+#include <stdint.h>
+
+#define SIM_REGISTER(name)  extern volatile uint8_t name;
+
+/* Status and reset */
+SIM_REGISTER(SREG)
+SIM_REGISTER(MCUCSR)
+
+/* GPIO */
+SIM_REGISTER(PORTB)
+SIM_REGISTER(DDRB)
+SIM_REGISTER(PINB)
+SIM_REGISTER(PORTC)
+SIM_REGISTER(DDRC)
+SIM_REGISTER(PINC)
+SIM_REGISTER(PORTD)
+SIM_REGISTER(DDRD)
+SIM_REGISTER(PIND)
+
+/* ADC */
+SIM_REGISTER(ADMUX)
+SIM_REGISTER(ADCSRA)
+SIM_REGISTER(ADCL)
+SIM_REGISTER(ADCH)
+
+/* Timers */
+SIM_REGISTER(TCCR0)
+SIM_REGISTER(TCNT0)
+SIM_REGISTER(TCCR2)
+SIM_REGISTER(TCNT2)
+SIM_REGISTER(OCR2)
+SIM_REGISTER(TIMSK)
+SIM_REGISTER(TIFR)
+
+/* SPI */
+SIM_REGISTER(SPCR)
+SIM_REGISTER(SPSR)
+SIM_REGISTER(SPDR)
+
+/* USART */
+SIM_REGISTER(UBRRH)
+SIM_REGISTER(UBRRL)
+SIM_REGISTER(UCSRA)
+SIM_REGISTER(UCSRB)
+SIM_REGISTER(UCSRC)
+SIM_REGISTER(UDR)
+
+/* SREG */
+#define SREG_I      7
+
+/* MCUCSR */
+#define WDRF        3
+#define BORF        2
+#define EXTRF       1
+#define PORF        0
+
+/* ADMUX */
+#define REFS1       7
+#define REFS0       6
+#define ADLAR       5
+#define MUX3        3
+#define MUX2        2
+#define MUX1        1
+#define MUX0        0
+
+/* ADCSRA */
+#define ADEN        7
+#define ADSC        6
+#define ADFR        5
+#define ADIF        4
+#define ADIE        3
+#define ADPS2       2
+#define ADPS1       1
+#define ADPS0       0
+
+/* TCCR0, TCCR2 */
+#define CS02        2
+#define CS01        1
+#define CS00        0
+#define WGM21       3
+#define CS22        2
+#define CS21        1
+#define CS20        0
+
+/* TIMSK, TIFR */
+#define OCIE2       7
+#define TOIE2       6
+#define TOIE0       0
+#define OCF2        7
+#define TOV2        6
+#define TOV0        0
+
+/* SPCR, SPSR */
+#define SPIE        7
+#define SPE         6
+#define DORD        5
+#define MSTR        4
+#define CPOL        3
+#define CPHA        2
+#define SPR1        1
+#define SPR0        0
+#define SPIF        7
+#define SPI2X       0
+
+/* UCSRA, UCSRB, UCSRC */
+#define RXC         7
+#define TXC         6
+#define UDRE        5
+#define U2X         1
+#define RXCIE       7
+#define TXCIE       6
+#define UDRIE       5
+#define RXEN        4
+#define TXEN        3
+#define URSEL       7
+#define UCSZ1       2
+#define UCSZ0       1
+
+/* Port pins */
+#define PB0         0
+#define PB1         1
+#define PB2         2
+#define PB3         3
+#define PB4         4
+#define PB5         5
+#define PB6         6
+#define PB7         7
+#define PD0         0
+#define PD1         1
+#define PD2         2
+#define PD3         3
+#define PD4         4
+#define PD5         5
+#define PD6         6
+#define PD7         7
+
+#define _BV(bit)    (1U << (bit))
+#define bit_is_set(reg, bit)            (((reg) & _BV(bit)) != 0U)
+#define bit_is_clear(reg, bit)          (((reg) & _BV(bit)) == 0U)
+#define loop_until_bit_is_set(reg, bit)     do { } while (bit_is_clear(reg, bit))
+#define loop_until_bit_is_clear(reg, bit)   do { } while (bit_is_set(reg, bit))
+
+#endif /* SIM_AVR_IO_H_ */
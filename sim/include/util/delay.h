@@ -0,0 +1,37 @@
+/*
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+    Lorenzo Miori (C) 2016 [ 3M4|L: memoryS60<at>gmail.com ]
+
+    Version History
+        * 1.0 initial
+
+*/
+
+/**
+ * @file delay.h
+ * @author Lorenzo Miori
+ * @date Oct 2016
+ * @brief Host simulation: busy waits follow the simulated time
+ */
+
+#ifndef SIM_UTIL_DELAY_H_
+#define SIM_UTIL_DELAY_H_
+
+#define _delay_us(us)   sim_delay_us((double)(us))
+#define _delay_ms(ms)   sim_delay_us((double)(ms) * 1000.0)
+
+void sim_delay_us(double us);
+
+#endif /* SIM_UTIL_DELAY_H_ */
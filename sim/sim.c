@@ -0,0 +1,200 @@
+/*
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+    Lorenzo Miori (C) 2016 [ 3M4|L: memoryS60<at>gmail.com ]
+
+    Version History
+        * 1.0 initial
+
+*/
+
+/**
+ * @file sim.c
+ * @author Lorenzo Miori
+ * @date Oct 2016
+ * @brief Host simulation: runs the firmware against the ncurses display
+ *        HAL, with the audio inputs fed from a WAV file
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include <unistd.h>
+#include <ncurses.h>
+
+#include <avr/io.h>
+
+#include "../src/deasplay/deasplay.h"
+#include "../src/deasplay/configuration.h"
+#include "sim.h"
+
+#define SIM_STATUS_NS       250000000ULL    /**< Status line refresh (simulated time) */
+
+static const char *eeprom_path = NULL;
+static double limit_s = 0.0;                /**< Stop after this time (0: at the end of the audio) */
+static uint64_t host_start_ns;
+static uint64_t status_ns = 0U;
+static bool looped = false;
+
+int firmware_main(void);
+
+static void sim_usage(const char *name)
+{
+    fprintf(stderr,
+            "Usage: %s [options] [file.wav]\n"
+            "  -s <speed>   simulated seconds per second (default 1)\n"
+            "  -g <gain>    input gain, 1: full scale is the ADC range (default 1)\n"
+            "  -t <s>       stop after this simulated time\n"
+            "  -l           loop the audio\n"
+            "  -d           hold SELECT at the reset (debug page)\n"
+            "  -e <file>    EEPROM contents, saved at the exit\n"
+            "Keys: s/enter SELECT, up/k UP, down/j DOWN, q quit\n", name);
+}
+
+static uint64_t sim_host_ns(void)
+{
+    struct timespec now;
+
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return ((uint64_t)now.tv_sec * 1000000000ULL) + (uint64_t)now.tv_nsec;
+}
+
+static void sim_report(void)
+{
+    double simulated = (double)sim_time_ns() / 1e9;
+    double host = (double)(sim_host_ns() - host_start_ns) / 1e9;
+    t_display_frames *frames = display_frame_stats();
+
+    if ((eeprom_path != NULL) && (sim_eeprom_save(eeprom_path) == false))
+    {
+        perror(eeprom_path);
+    }
+
+    printf("simulated time            %.2f s (%.2f s on the host)\n", simulated, host);
+    printf("ADC conversion periods    %llu\n", (unsigned long long)sim_conversions());
+    printf("frames dropped            %u\n", (unsigned int)frames->dropped);
+    printf("longest frame             %u us (simulated)\n", (unsigned int)frames->time_max);
+    ncurses_display_hal_report(stdout);
+}
+
+/* Called at every display poll, i.e. from the firmware main loop */
+void ncurses_display_hal_input(int key)
+{
+    char status[80];
+    uint64_t time = sim_time_ns();
+
+    switch (key)
+    {
+        case 's':
+        case ' ':
+        case '\n':
+        case KEY_ENTER:
+            sim_key_press(SIM_KEY_SELECT, SIM_KEY_CLICK_US);
+            break;
+        case 'k':
+        case KEY_UP:
+            sim_key_press(SIM_KEY_UP, SIM_KEY_CLICK_US);
+            break;
+        case 'j':
+        case KEY_DOWN:
+            sim_key_press(SIM_KEY_DOWN, SIM_KEY_CLICK_US);
+            break;
+        case 'q':
+            exit(EXIT_SUCCESS);
+            break;
+        default:
+            /* not a key of the device */
+            break;
+    }
+
+    if (((limit_s > 0.0) && (((double)time / 1e9) >= limit_s)) ||
+        ((limit_s <= 0.0) && (looped == false) && (sim_audio_finished() == true)))
+    {
+        exit(EXIT_SUCCESS);
+    }
+
+    if (time >= status_ns)
+    {
+        status_ns = time + SIM_STATUS_NS;
+        snprintf(status, sizeof(status), "%7.2f s  relays %u%u%u  drops %u  flush max %u us",
+                 (double)time / 1e9,
+                 (PORTD >> PD7) & 0x1U, (PORTD >> PD6) & 0x1U, (PORTD >> PD5) & 0x1U,
+                 (unsigned int)display_frame_stats()->dropped,
+                 (unsigned int)display_frame_stats()->time_max);
+        ncurses_display_hal_status(status);
+    }
+}
+
+int main(int argc, char *argv[])
+{
+    static t_sim_wav wav;
+    double speed = 1.0;
+    double gain = 1.0;
+    bool debug = false;
+    int option;
+
+    while ((option = getopt(argc, argv, "s:g:t:lde:h")) != -1)
+    {
+        switch (option)
+        {
+            case 's': speed = atof(optarg); break;
+            case 'g': gain = atof(optarg); break;
+            case 't': limit_s = atof(optarg); break;
+            case 'l': looped = true; break;
+            case 'd': debug = true; break;
+            case 'e': eeprom_path = optarg; break;
+            default:
+                sim_usage(argv[0]);
+                return EXIT_FAILURE;
+        }
+    }
+
+    if (speed <= 0.0)
+    {
+        sim_usage(argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    if (optind < argc)
+    {
+        if (sim_wav_load(argv[optind], &wav) == false)
+        {
+            return EXIT_FAILURE;
+        }
+        sim_audio(&wav, gain, looped);
+    }
+    else
+    {
+        /* silence, until quit */
+        looped = true;
+    }
+
+    if ((eeprom_path != NULL) && (sim_eeprom_load(eeprom_path) == false))
+    {
+        perror(eeprom_path);
+        return EXIT_FAILURE;
+    }
+
+    /* registered before the display: runs after the terminal is restored */
+    atexit(sim_report);
+
+    host_start_ns = sim_host_ns();
+    sim_start(speed);
+    if (debug == true)
+    {
+        sim_key_press(SIM_KEY_SELECT, SIM_KEY_BOOT_US);
+    }
+
+    return firmware_main();
+}
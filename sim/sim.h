@@ -0,0 +1,76 @@
+/*
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+    Lorenzo Miori (C) 2016 [ 3M4|L: memoryS60<at>gmail.com ]
+
+    Version History
+        * 1.0 initial
+
+*/
+
+/**
+ * @file sim.h
+ * @author Lorenzo Miori
+ * @date Oct 2016
+ * @brief Host simulation of the ManageAudio hardware: simulated time,
+ *        ADC fed from a WAV file, keys and EEPROM
+ */
+
+#ifndef SIM_SIM_H_
+#define SIM_SIM_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#define SIM_ADC_RATE        19200UL     /**< Conversions per second (see README.md) */
+#define SIM_ADC_ZERO        512         /**< ADC reading of the zero level */
+#define SIM_TIMER0_NS       100000UL    /**< Timer0 overflow period (time.c) */
+#define SIM_TICK_US         250L        /**< Host timer period: the interrupts catch up at this pace */
+
+#define SIM_KEY_SELECT      0U          /**< PB0, KEY_1 in manage_audio.c */
+#define SIM_KEY_UP          1U          /**< PB1, KEY_2 */
+#define SIM_KEY_DOWN        2U          /**< PB2, KEY_3 */
+#define SIM_KEY_CLICK_US    80000UL     /**< A click: longer than the debounce, shorter than a hold */
+#define SIM_KEY_BOOT_US     1500000UL   /**< Held from the reset (debug page) */
+
+/** An audio file, as interleaved stereo samples */
+typedef struct
+{
+    int16_t  *samples;      /**< Left and right, one pair per frame */
+    uint32_t frames;        /**< Length */
+    uint32_t rate;          /**< Frames per second */
+} t_sim_wav;
+
+/* Simulated time and interrupts */
+void sim_start(double speed);
+uint64_t sim_time_ns(void);
+uint64_t sim_conversions(void);
+
+/* Audio */
+void sim_audio(const t_sim_wav *wav, double gain, bool loop);
+bool sim_audio_finished(void);
+bool sim_wav_load(const char *path, t_sim_wav *wav);
+
+/* Keys */
+void sim_key_press(uint8_t key, uint32_t duration_us);
+
+/* EEPROM */
+bool sim_eeprom_load(const char *path);
+bool sim_eeprom_save(const char *path);
+
+/* Interrupt handlers of the firmware */
+void TIMER0_OVF_vect(void);
+void ADC_vect(void);
+
+#endif /* SIM_SIM_H_ */
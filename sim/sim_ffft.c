@@ -0,0 +1,168 @@
+/*
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+    Lorenzo Miori (C) 2016 [ 3M4|L: memoryS60<at>gmail.com ]
+
+    Version History
+        * 1.0 initial
+
+*/
+
+/**
+ * @file sim_ffft.c
+ * @author Lorenzo Miori
+ * @date Oct 2016
+ * @brief Host simulation: C port of ffft.S (fixed-point FFT, (C)ChaN 2005).
+ *        Same tables and same fixed-point arithmetic, FFT_N = 64 only.
+ */
+
+#include <stdint.h>
+
+#include "../src/ffft.h"
+
+#if FFT_N != 64
+#error "Only the 64 points tables are ported"
+#endif
+
+#define FFT_B   6
+
+/* Hamming window, as in ffft.S */
+const prog_int16_t tbl_window[FFT_N] = {
+     2621,  2693,  2910,  3270,  3768,  4401,  5161,  6042,  7036,  8132,  9320, 10588, 11926, 13318, 14753, 16216,
+    17694, 19171, 20634, 22069, 23462, 24799, 26068, 27256, 28352, 29345, 30226, 30987, 31619, 32117, 32477, 32694,
+    32766, 32694, 32477, 32117, 31619, 30987, 30226, 29345, 28352, 27256, 26068, 24799, 23462, 22069, 20634, 19171,
+    17694, 16216, 14753, 13318, 11926, 10588,  9320,  8132,  7036,  6042,  5161,  4401,  3768,  3270,  2910,  2693
+};
+
+/* {cos(x), sin(x)}, 0 <= x < pi in FFT_N/2 steps, as in ffft.S */
+static const int16_t tbl_cos_sin[FFT_N] = {
+    32767, 0, 32609, 3211, 32137, 6392, 31356, 9511, 30272, 12539, 28897, 15446, 27244, 18204, 25329, 20787,
+    23169, 23169, 20787, 25329, 18204, 27244, 15446, 28897, 12539, 30272, 9511, 31356, 6392, 32137, 3211, 32609,
+    0, 32766, -3211, 32609, -6392, 32137, -9511, 31356, -12539, 30272, -15446, 28897, -18204, 27244, -20787, 25329,
+    -23169, 23169, -25329, 20787, -27244, 18204, -28897, 15446, -30272, 12539, -31356, 9511, -32137, 6392, -32609, 3211
+};
+
+/* FMULS16: signed fractional product, 1.31 */
+static int32_t fmuls16(int16_t a, int16_t b)
+{
+    return (int32_t)((uint32_t)((int32_t)a * b) << 1);
+}
+
+/* floor(sqrt(x)) */
+static uint32_t usqrt(uint32_t x)
+{
+    uint32_t root = 0U;
+    uint32_t bit = 1UL << 30;
+
+    while (bit > x) bit >>= 2;
+    while (bit != 0U)
+    {
+        if (x >= (root + bit))
+        {
+            x -= root + bit;
+            root = (root >> 1) + bit;
+        }
+        else
+        {
+            root >>= 1;
+        }
+        bit >>= 2;
+    }
+
+    return root;
+}
+
+void fft_input(const int16_t *array_src, complex_t *array_bfly)
+{
+    uint16_t i;
+
+    for (i = 0U; i < FFT_N; i++)
+    {
+        array_bfly[i].r = (int16_t)(fmuls16(tbl_window[i], array_src[i]) >> 16);
+        array_bfly[i].i = array_bfly[i].r;
+    }
+}
+
+void fft_execute(complex_t *array_bfly)
+{
+    uint16_t e;         /* angular speed */
+    uint16_t x;         /* butterfly span */
+    uint16_t group;
+    uint16_t angle;
+    complex_t *z;
+    complex_t *y;
+    int16_t a;
+    int16_t b;
+    int16_t c;
+    int16_t d;
+
+    for (e = 1U, x = FFT_N / 2U; x != 0U; e <<= 1, x >>= 1)
+    {
+        z = &array_bfly[0];
+        y = &array_bfly[x];
+        for (group = 0U; group < e; group++)
+        {
+            for (angle = 0U; angle < (FFT_N / 2U); angle += e)
+            {
+                a = (int16_t)((z->r >> 1) - (y->r >> 1));
+                z->r = (int16_t)((z->r >> 1) + (y->r >> 1));
+                b = (int16_t)((z->i >> 1) - (y->i >> 1));
+                z->i = (int16_t)((z->i >> 1) + (y->i >> 1));
+                z++;
+                c = tbl_cos_sin[angle * 2U];
+                d = tbl_cos_sin[(angle * 2U) + 1U];
+                y->r = (int16_t)((uint32_t)(fmuls16(a, c) + fmuls16(b, d)) >> 16);
+                y->i = (int16_t)((uint32_t)(fmuls16(b, c) - fmuls16(a, d)) >> 16);
+                y++;
+            }
+            /* skip the split segment */
+            y += x;
+            z += x;
+        }
+    }
+}
+
+void fft_output(const complex_t *array_bfly, uint16_t *array_dst)
+{
+    uint16_t i;
+    uint16_t j;
+    uint16_t bit;
+    const complex_t *p;
+
+    for (i = 0U; i < (FFT_N / 2U); i++)
+    {
+        /* bit reversed order */
+        for (j = 0U, bit = 0U; bit < FFT_B; bit++)
+        {
+            j |= (uint16_t)(((i >> bit) & 0x1U) << (FFT_B - 1U - bit));
+        }
+        p = &array_bfly[j];
+        array_dst[i] = (uint16_t)usqrt((uint32_t)fmuls16(p->r, p->r) + (uint32_t)fmuls16(p->i, p->i));
+    }
+}
+
+int16_t fmuls_f(int16_t a, int16_t b)
+{
+    return (int16_t)(fmuls16(a, b) >> 16);
+}
+
+uint16_t fast_usqrt32(uint32_t x)
+{
+    return (uint16_t)usqrt(x);
+}
+
+uint8_t fast_usqrt16(uint16_t x)
+{
+    return (uint8_t)usqrt(x);
+}
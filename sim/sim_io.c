@@ -0,0 +1,437 @@
+/*
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+    Lorenzo Miori (C) 2016 [ 3M4|L: memoryS60<at>gmail.com ]
+
+    Version History
+        * 1.0 initial
+
+*/
+
+/**
+ * @file sim_io.c
+ * @author Lorenzo Miori
+ * @date Oct 2016
+ * @brief Host simulation: registers, simulated time and interrupts.
+ *
+ * A host timer (SIGALRM) interrupts the firmware every SIM_TICK_US, just
+ * like a real interrupt would, and catches up with the simulated time:
+ * Timer0 overflows every 100us and, while a conversion is started, the ADC
+ * returns the WAV sample due at that time. The handlers only run with the
+ * I bit of SREG set, otherwise they wait for sei(). The simulated time
+ * runs at "speed" times the host time.
+ */
+
+#include <errno.h>
+#include <signal.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/time.h>
+#include <time.h>
+
+#include <avr/io.h>
+#include <avr/interrupt.h>
+#include <avr/eeprom.h>
+#include <util/delay.h>
+
+#include "sim.h"
+
+#define SIM_NS_PER_S    1000000000ULL
+
+/* Registers */
+volatile uint8_t SREG;
+volatile uint8_t MCUCSR = (1U << PORF);
+volatile uint8_t PORTB;
+volatile uint8_t DDRB;
+volatile uint8_t PINB = 0xFFU;          /* pull-ups: no key pressed */
+volatile uint8_t PORTC;
+volatile uint8_t DDRC;
+volatile uint8_t PINC = 0xFFU;
+volatile uint8_t PORTD;
+volatile uint8_t DDRD;
+volatile uint8_t PIND = 0xFFU;
+volatile uint8_t ADMUX;
+volatile uint8_t ADCSRA;
+volatile uint8_t ADCL;
+volatile uint8_t ADCH;
+volatile uint8_t TCCR0;
+volatile uint8_t TCNT0;
+volatile uint8_t TCCR2;
+volatile uint8_t TCNT2;
+volatile uint8_t OCR2;
+volatile uint8_t TIMSK;
+volatile uint8_t TIFR;
+volatile uint8_t SPCR;
+volatile uint8_t SPSR;
+volatile uint8_t SPDR;
+volatile uint8_t UBRRH;
+volatile uint8_t UBRRL;
+volatile uint8_t UCSRA = (1U << UDRE);  /* the transmitter is always ready */
+volatile uint8_t UCSRB;
+volatile uint8_t UCSRC;
+volatile uint8_t UDR;
+
+static double speed = 1.0;
+static uint64_t host_start_ns;
+static volatile sig_atomic_t pending = 0;   /**< Tick while the interrupts were disabled */
+static uint64_t now_ns = 0U;                /**< Time of the last event */
+static uint64_t timer_overflows = 0U;
+static uint64_t conversions = 0U;           /**< ADC periods elapsed */
+
+static const t_sim_wav *audio = NULL;
+static int32_t audio_gain = 256;            /**< Q8 */
+static bool audio_loop = false;
+static volatile bool audio_finished = false;
+
+static volatile uint64_t key_release_ns[8]; /**< When the keys go back up (0: not pressed) */
+
+static uint8_t eeprom[E2END + 1U];
+
+static uint64_t sim_host_ns(void)
+{
+    struct timespec now;
+
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return ((uint64_t)now.tv_sec * SIM_NS_PER_S) + (uint64_t)now.tv_nsec;
+}
+
+/**
+ * sim_time_ns
+ *
+ * @brief The simulated time
+ * @return nanoseconds since sim_start()
+ */
+uint64_t sim_time_ns(void)
+{
+    return (uint64_t)((double)(sim_host_ns() - host_start_ns) * speed);
+}
+
+/**
+ * sim_conversions
+ *
+ * @brief ADC conversion periods elapsed
+ */
+uint64_t sim_conversions(void)
+{
+    return conversions;
+}
+
+static uint16_t sim_adc_sample(uint8_t channel)
+{
+    uint64_t frame;
+    int32_t value;
+
+    if (audio == NULL)
+    {
+        return SIM_ADC_ZERO;
+    }
+
+    frame = (now_ns * audio->rate) / SIM_NS_PER_S;
+    if (frame >= audio->frames)
+    {
+        if (audio_loop == true)
+        {
+            frame %= audio->frames;
+        }
+        else
+        {
+            audio_finished = true;
+            return SIM_ADC_ZERO;
+        }
+    }
+
+    /* full scale: the whole ADC range around the zero level */
+    value = SIM_ADC_ZERO + ((((int32_t)audio->samples[(frame * 2U) + channel] * audio_gain) / 256) >> 6);
+    if (value < 0) value = 0;
+    if (value > 1023) value = 1023;
+
+    return (uint16_t)value;
+}
+
+static void sim_adc_convert(void)
+{
+    uint16_t value;
+
+    if (((ADCSRA & (1U << ADEN)) != 0U) && ((ADCSRA & (1U << ADSC)) != 0U))
+    {
+        value = sim_adc_sample(ADMUX & (1U << MUX0));
+        ADCL = (uint8_t)value;
+        ADCH = (uint8_t)(value >> 8);
+        ADCSRA &= (uint8_t)~(1U << ADSC);
+        if ((ADCSRA & (1U << ADIE)) != 0U)
+        {
+            ADC_vect();
+        }
+        else
+        {
+            ADCSRA |= (1U << ADIF);
+        }
+    }
+    else
+    {
+        /* idle */
+    }
+}
+
+/* Run the interrupts due until now, in time order (the I bit is clear) */
+static void sim_run(void)
+{
+    uint64_t time = sim_time_ns();
+    uint64_t timer_ns;
+    uint64_t adc_ns;
+
+    for (;;)
+    {
+        timer_ns = (timer_overflows + 1U) * SIM_TIMER0_NS;
+        adc_ns = ((conversions + 1U) * SIM_NS_PER_S) / SIM_ADC_RATE;
+
+        if (timer_ns <= adc_ns)
+        {
+            if (timer_ns > time) break;
+            now_ns = timer_ns;
+            timer_overflows++;
+            if (((TCCR0 & 0x7U) != 0U) && ((TIMSK & (1U << TOIE0)) != 0U))
+            {
+                TIMER0_OVF_vect();
+            }
+        }
+        else
+        {
+            if (adc_ns > time) break;
+            now_ns = adc_ns;
+            conversions++;
+            sim_adc_convert();
+        }
+    }
+}
+
+static void sim_keys(void)
+{
+    uint64_t time = sim_time_ns();
+    uint8_t i;
+
+    for (i = 0U; i < 8U; i++)
+    {
+        if ((key_release_ns[i] != 0U) && (time >= key_release_ns[i]))
+        {
+            key_release_ns[i] = 0U;
+            PINB |= (uint8_t)(1U << i);
+        }
+    }
+}
+
+static void sim_tick(int signal)
+{
+    (void)signal;
+
+    /* the keys do not wait for the interrupts */
+    sim_keys();
+
+    if ((SREG & (1U << SREG_I)) != 0U)
+    {
+        SREG &= (uint8_t)~(1U << SREG_I);
+        sim_run();
+        SREG |= (1U << SREG_I);
+    }
+    else
+    {
+        pending = 1;
+    }
+}
+
+/**
+ * sim_sei
+ *
+ * @brief Enable the interrupts, running those that became due meanwhile
+ */
+void sim_sei(void)
+{
+    SREG |= (1U << SREG_I);
+    if (pending != 0)
+    {
+        pending = 0;
+        SREG &= (uint8_t)~(1U << SREG_I);
+        sim_run();
+        SREG |= (1U << SREG_I);
+    }
+}
+
+/**
+ * sim_delay_us
+ *
+ * @brief Busy wait, in simulated time
+ */
+void sim_delay_us(double us)
+{
+    uint64_t end = sim_time_ns() + (uint64_t)(us * 1000.0);
+    uint64_t time;
+    struct timespec wait;
+
+    while ((time = sim_time_ns()) < end)
+    {
+        wait.tv_sec = 0;
+        wait.tv_nsec = (long)((double)(end - time) / speed);
+        if (wait.tv_nsec > (SIM_TICK_US * 1000L)) wait.tv_nsec = SIM_TICK_US * 1000L;
+        nanosleep(&wait, NULL);
+    }
+}
+
+/**
+ * sim_start
+ *
+ * @brief Start the simulated time (the reset)
+ * @param speed     simulated seconds per host second
+ */
+void sim_start(double time_speed)
+{
+    struct sigaction action;
+    struct itimerval timer;
+
+    speed = time_speed;
+    host_start_ns = sim_host_ns();
+
+    memset(&action, 0, sizeof(action));
+    action.sa_handler = sim_tick;
+    action.sa_flags = SA_RESTART;
+    sigemptyset(&action.sa_mask);
+    sigaction(SIGALRM, &action, NULL);
+
+    timer.it_interval.tv_sec = 0;
+    timer.it_interval.tv_usec = SIM_TICK_US;
+    timer.it_value = timer.it_interval;
+    setitimer(ITIMER_REAL, &timer, NULL);
+}
+
+/**
+ * sim_audio
+ *
+ * @brief Connect an audio file to the ADC inputs
+ * @param wav   the audio (NULL: silence)
+ * @param gain  linear gain, 1.0: full scale is the ADC range
+ * @param loop  restart at the end instead of finishing
+ */
+void sim_audio(const t_sim_wav *wav, double gain, bool loop)
+{
+    audio = wav;
+    audio_gain = (int32_t)(gain * 256.0);
+    audio_loop = loop;
+}
+
+/**
+ * sim_audio_finished
+ *
+ * @return true when the ADC has reached the end of the audio
+ */
+bool sim_audio_finished(void)
+{
+    return audio_finished;
+}
+
+/**
+ * sim_key_press
+ *
+ * @brief Pull a key down for a while
+ * @param key           the PINB bit
+ * @param duration_us   how long it stays pressed
+ */
+void sim_key_press(uint8_t key, uint32_t duration_us)
+{
+    key_release_ns[key] = sim_time_ns() + ((uint64_t)duration_us * 1000U);
+    PINB &= (uint8_t)~(1U << key);
+}
+
+/**
+ * sim_eeprom_load
+ *
+ * @brief Fill the EEPROM from a file (erased when it does not exist)
+ */
+bool sim_eeprom_load(const char *path)
+{
+    FILE *file;
+    bool ok = false;
+
+    memset(eeprom, 0xFF, sizeof(eeprom));
+    file = fopen(path, "rb");
+    if (file != NULL)
+    {
+        ok = (fread(eeprom, 1U, sizeof(eeprom), file) == sizeof(eeprom));
+        fclose(file);
+    }
+    else
+    {
+        ok = (errno == ENOENT);
+    }
+
+    return ok;
+}
+
+/**
+ * sim_eeprom_save
+ *
+ * @brief Write the EEPROM to a file
+ */
+bool sim_eeprom_save(const char *path)
+{
+    FILE *file;
+    bool ok = false;
+
+    file = fopen(path, "wb");
+    if (file != NULL)
+    {
+        ok = (fwrite(eeprom, 1U, sizeof(eeprom), file) == sizeof(eeprom));
+        ok = (fclose(file) == 0) && ok;
+    }
+
+    return ok;
+}
+
+uint8_t eeprom_read_byte(const uint8_t *addr)
+{
+    return eeprom[(uintptr_t)addr & E2END];
+}
+
+void eeprom_write_byte(uint8_t *addr, uint8_t value)
+{
+    eeprom[(uintptr_t)addr & E2END] = value;
+}
+
+void eeprom_update_byte(uint8_t *addr, uint8_t value)
+{
+    eeprom_write_byte(addr, value);
+}
+
+void eeprom_read_block(void *dst, const void *src, size_t n)
+{
+    size_t i;
+
+    for (i = 0U; i < n; i++)
+    {
+        ((uint8_t*)dst)[i] = eeprom_read_byte((const uint8_t*)src + i);
+    }
+}
+
+void eeprom_write_block(const void *src, void *dst, size_t n)
+{
+    size_t i;
+
+    for (i = 0U; i < n; i++)
+    {
+        eeprom_write_byte((uint8_t*)dst + i, ((const uint8_t*)src)[i]);
+    }
+}
+
+void eeprom_update_block(const void *src, void *dst, size_t n)
+{
+    eeprom_write_block(src, dst, n);
+}
@@ -0,0 +1,151 @@
+/*
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+    Lorenzo Miori (C) 2016 [ 3M4|L: memoryS60<at>gmail.com ]
+
+    Version History
+        * 1.0 initial
+
+*/
+
+/**
+ * @file sim_wav.c
+ * @author Lorenzo Miori
+ * @date Oct 2016
+ * @brief Host simulation: WAV file loader (PCM, 8 or 16 bits, mono or stereo)
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "sim.h"
+
+#define WAV_FORMAT_PCM          0x0001U
+#define WAV_FORMAT_EXTENSIBLE   0xFFFEU
+
+static uint32_t wav_le32(const uint8_t *p)
+{
+    return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+static uint16_t wav_le16(const uint8_t *p)
+{
+    return (uint16_t)(p[0] | (p[1] << 8));
+}
+
+/**
+ * sim_wav_load
+ *
+ * @brief Load a whole WAV file, as stereo 16 bits samples
+ * @param path  the file
+ * @param wav   where to store the audio
+ * @return false (and a message on stderr) when it cannot be used
+ */
+bool sim_wav_load(const char *path, t_sim_wav *wav)
+{
+    FILE *file;
+    uint8_t header[12];
+    uint8_t chunk[8];
+    uint8_t fmt[16];
+    uint8_t *data = NULL;
+    uint32_t size;
+    uint16_t format = 0U;
+    uint16_t channels = 0U;
+    uint16_t bits = 0U;
+    uint32_t bytes = 0U;
+    uint32_t i;
+    uint16_t c;
+    int16_t sample;
+
+    file = fopen(path, "rb");
+    if (file == NULL)
+    {
+        perror(path);
+        return false;
+    }
+
+    if ((fread(header, 1U, sizeof(header), file) != sizeof(header)) ||
+        (memcmp(header, "RIFF", 4U) != 0) || (memcmp(&header[8], "WAVE", 4U) != 0))
+    {
+        fprintf(stderr, "%s: not a WAV file\n", path);
+        fclose(file);
+        return false;
+    }
+
+    wav->rate = 0U;
+    while ((data == NULL) && (fread(chunk, 1U, sizeof(chunk), file) == sizeof(chunk)))
+    {
+        size = wav_le32(&chunk[4]);
+        if ((memcmp(chunk, "fmt ", 4U) == 0) && (size >= sizeof(fmt)))
+        {
+            if (fread(fmt, 1U, sizeof(fmt), file) != sizeof(fmt)) break;
+            format = wav_le16(&fmt[0]);
+            channels = wav_le16(&fmt[2]);
+            wav->rate = wav_le32(&fmt[4]);
+            bits = wav_le16(&fmt[14]);
+            size -= sizeof(fmt);
+        }
+        else if ((memcmp(chunk, "data", 4U) == 0) && (wav->rate != 0U))
+        {
+            data = malloc(size);
+            bytes = (data == NULL) ? 0U : (uint32_t)fread(data, 1U, size, file);
+            size = 0U;
+        }
+        else
+        {
+            /* not needed */
+        }
+        /* chunks are word aligned */
+        fseek(file, (long)(size + (size & 0x1U)), SEEK_CUR);
+    }
+    fclose(file);
+
+    if ((data == NULL) || (channels == 0U) || (channels > 2U) || ((bits != 8U) && (bits != 16U)) ||
+        ((format != WAV_FORMAT_PCM) && (format != WAV_FORMAT_EXTENSIBLE)))
+    {
+        fprintf(stderr, "%s: only 8 or 16 bits PCM, mono or stereo, is supported\n", path);
+        free(data);
+        return false;
+    }
+
+    wav->frames = bytes / (channels * (bits / 8U));
+    wav->samples = malloc((size_t)wav->frames * 2U * sizeof(int16_t));
+    if (wav->samples == NULL)
+    {
+        fprintf(stderr, "%s: out of memory\n", path);
+        free(data);
+        return false;
+    }
+
+    for (i = 0U; i < wav->frames; i++)
+    {
+        for (c = 0U; c < 2U; c++)
+        {
+            /* mono: the same samples on both channels */
+            if (bits == 8U)
+            {
+                sample = (int16_t)((data[(i * channels) + (c % channels)] - 128) << 8);
+            }
+            else
+            {
+                sample = (int16_t)wav_le16(&data[((i * channels) + (c % channels)) * 2U]);
+            }
+            wav->samples[(i * 2U) + c] = sample;
+        }
+    }
+    free(data);
+
+    return true;
+}
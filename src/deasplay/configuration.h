@@ -45,12 +45,24 @@
  * NOTE: this might take up to 2kB of code memory! */
 /* #define DISPLAY_HAS_PRINTF */
 
+/** Define DEASPLAY_BUS_STATS to count the display bus traffic
+ * (see display_bus_stats()). It goes in the compiler flags
+ * (-DDEASPLAY_BUS_STATS): the drivers are built without this file */
+
 /** This is the core feature: define here the driver your
  * project uses. Please see source or documentation for
  * hints about the available devices */
+#if !defined(DEASPLAY_HD44780) && !defined(DEASPLAY_UART) && !defined(DEASPLAY_NCURSES)
 #define DEASPLAY_LC75710
+#endif
 /*#define DEASPLAY_HD44780*/
+/*#define DEASPLAY_UART*/
+/*#define DEASPLAY_NCURSES*/    /* host builds only, see sim/ */
 
 #include "deasplay_hal.h"
 
+/** Free running microseconds clock, paces display_frame_periodic() */
+#include "../time.h"
+#define DEASPLAY_TIMESTAMP  g_timestamp
+
 #endif /* SRC_DEASPLAY_H_ */
@@ -31,23 +31,119 @@
 #include <stdbool.h>
 
 #include <stdio.h>  /* printf-like facility */
+#include <stdarg.h>
 
 #include "configuration.h"
 
 #define DEASPLAY_BUFFER_ELEMENTS        (DEASPLAY_LINES * DEASPLAY_CHARS)
 #define DEASPLAY_BUFFER_INDEX_MAX       (DEASPLAY_BUFFER_ELEMENTS - 1U)
 
+#ifndef DEASPLAY_RUN_MERGE
+#define DEASPLAY_RUN_MERGE              2U  /**< Unchanged elements re-sent to join two runs */
+#endif
+
 static t_display_status display_status;
 static t_display_elem   display_buffer[DEASPLAY_BUFFER_ELEMENTS];
+static t_display_frames display_frames;
+static t_display_overlay display_overlay_state;
+static t_display_marquee display_marquee_state;
+static t_display_blink  display_blink_state;
+static uint32_t         display_blink_mask[DEASPLAY_LINES];    /**< Blinking characters, a bit per character */
+static uint8_t          overlay_buffer[DEASPLAY_CHARS];
+static t_display_glyphs display_glyphs;
+#ifdef DEASPLAY_BUS_STATS
+static t_display_bus_stats display_bus;
+#endif
 
 #ifdef DISPLAY_HAS_PRINTF
 static char snprintf_buf[DEASPLAY_BUFFER_ELEMENTS];
 #endif
 
+static void display_dirty_reset(void)
+{
+    /* empty range: first after last */
+    display_status.dirty_first = (uint8_t)DEASPLAY_BUFFER_ELEMENTS;
+    display_status.dirty_last = 0U;
+}
+
+static void display_dirty_mark(uint8_t index)
+{
+    if (index < display_status.dirty_first) display_status.dirty_first = index;
+    if (index > display_status.dirty_last) display_status.dirty_last = index;
+}
+
+static void display_dirty_range(uint8_t first, uint8_t len)
+{
+    if (len > 0U)
+    {
+        display_dirty_mark(first);
+        display_dirty_mark(first + len - 1U);
+    }
+}
+
+/* The visible character: the overlay where it covers the base layer */
+static uint8_t display_composite(uint8_t index)
+{
+    uint8_t offset = index - display_overlay_state.first;   /* wraps around when before the overlay */
+
+    return (offset < display_overlay_state.len) ? overlay_buffer[offset] : display_buffer[index].character;
+}
+
+/* The custom glyph slots the visible characters use, a bit each */
+static uint32_t display_glyph_mask(void)
+{
+    uint32_t mask = 0U;
+    uint8_t i;
+    uint8_t chr;
+
+    for (i = 0U; i < DEASPLAY_BUFFER_ELEMENTS; i++)
+    {
+        chr = display_composite(i);
+        if (chr < DEASPLAY_GLYPHS) mask |= (1UL << chr);
+    }
+
+    return mask;
+}
+
+/* Send the blink attributes to the controller, or run the software blinking */
+static void display_blink_periodic(void)
+{
+    uint8_t line;
+
+#ifdef deasplay_hal_blink
+    if (display_blink_state.update == true)
+    {
+        display_blink_state.update = false;
+        for (line = 0U; line < DEASPLAY_LINES; line++)
+        {
+            deasplay_hal_blink(line, display_blink_mask[line], display_blink_state.period);
+        }
+    }
+#else
+    if ((display_blink_state.period != 0U) &&
+        ((DEASPLAY_TIMESTAMP - display_blink_state.timestamp) >= display_blink_state.half))
+    {
+        display_blink_state.timestamp += display_blink_state.half;
+        if ((DEASPLAY_TIMESTAMP - display_blink_state.timestamp) >= display_blink_state.half)
+        {
+            /* late by more than a phase: re-synchronize */
+            display_blink_state.timestamp = DEASPLAY_TIMESTAMP;
+        }
+        display_blink_state.off = !display_blink_state.off;
+        for (line = 0U; line < DEASPLAY_LINES; line++)
+        {
+            if (display_blink_mask[line] != 0U) display_dirty_range(line * DEASPLAY_CHARS, DEASPLAY_CHARS);
+        }
+    }
+#endif
+}
+
 void display_init(void)
 {
     deasplay_hal_init();
     display_set_cursor(0, 0);
+    display_dirty_reset();
+    display_glyphs.budget = DEASPLAY_GLYPH_BUDGET;
 }
 
 void display_power(e_deasplay_power state)
@@ -65,6 +161,11 @@ void display_clear(void)
         display_buffer[i].character_prev = (uint8_t)'\0';    /* zero the previous buffer to force a complete redraw */
     }
 
+    display_marquee_clear();
+
+    display_status.dirty_first = 0U;
+    display_status.dirty_last = DEASPLAY_BUFFER_INDEX_MAX;
+
 }
 
 void display_clean(void)
@@ -74,22 +175,120 @@ void display_clean(void)
     for (i = 0; i < DEASPLAY_BUFFER_ELEMENTS; i++)
     {
         display_buffer[i].character = (uint8_t)' ';          /* space in the current buffer */
+        if (display_buffer[i].character_prev != (uint8_t)' ') display_dirty_mark(i);
     }
+
+    display_marquee_clear();
 }
 
 void display_periodic(void)
 {
+    uint8_t c;
     uint8_t i;
-    uint8_t line = 0U;
-    uint8_t chr = 0U;
+    uint8_t last;
+    uint8_t line;
+    uint8_t chr;
+#ifdef deasplay_hal_write_run
+    uint8_t run[DEASPLAY_CHARS];
+    uint8_t run_len = 0U;
+    uint8_t run_line = 0U;
+    uint8_t run_chr = 0U;
+#endif
 
-    for (i = 0; i < DEASPLAY_BUFFER_ELEMENTS; i++)
+#ifdef deasplay_hal_poll
+    /* the previous frames may still be on their way to the controller */
+    deasplay_hal_poll();
+#endif
+
+#ifdef deasplay_hal_frame_begin
+    deasplay_hal_frame_begin();
+#endif
+
+    if ((display_overlay_state.len > 0U) &&
+        ((DEASPLAY_TIMESTAMP - display_overlay_state.timestamp) >= display_overlay_state.duration))
     {
-        if (display_buffer[i].character != display_buffer[i].character_prev)
+        /* expired: the base layer shows again */
+        display_overlay_clear();
+    }
+
+    if ((display_marquee_state.text != NULL) &&
+        ((DEASPLAY_TIMESTAMP - display_marquee_state.timestamp) >= display_marquee_state.wait))
+    {
+        display_marquee_state.timestamp += display_marquee_state.wait;
+        display_marquee_state.wait = display_marquee_state.period;
+        c = display_marquee_state.next;
+        display_marquee_state.next++;
+        if (display_marquee_state.next >= (display_marquee_state.len + DEASPLAY_MARQUEE_GAP))
         {
-            display_buffer[i].character_prev = display_buffer[i].character;
+            /* gap done: the text starts again */
+            display_marquee_state.next = 0U;
+        }
+        display_scroll(display_marquee_state.line,
+                       (c < display_marquee_state.len) ? (uint8_t)display_marquee_state.text[c] : (uint8_t)' ');
+    }
+
+    display_blink_periodic();
+
+#ifdef deasplay_hal_shift
+    while (display_status.shift > 0U)
+    {
+        /* the controller moves what it shows: character_prev has followed */
+        deasplay_hal_shift();
+        display_status.shift--;
+    }
+#endif
+
+    if (display_status.dirty_first > display_status.dirty_last)
+    {
+        /* nothing has changed since the last refresh */
+        return;
+    }
+
+    i = display_status.dirty_first;
+    last = display_status.dirty_last;
+    display_dirty_reset();
+
+    line = i / DEASPLAY_CHARS;
+    chr = i % DEASPLAY_CHARS;
+
+    for (; i <= last; i++)
+    {
+        c = display_composite(i);
+#ifndef deasplay_hal_blink
+        if ((display_blink_state.off == true) && (display_blink_mask[line] != 0U) &&
+            (((display_blink_mask[line] >> chr) & 0x1U) != 0U))
+        {
+            /* hidden by the blink attribute */
+            c = (uint8_t)' ';
+        }
+#endif
+        if (c != display_buffer[i].character_prev)
+        {
+            display_buffer[i].character_prev = c;
+#ifdef deasplay_hal_write_run
+            if ((run_len != 0U) && ((line != run_line) || ((chr - (run_chr + run_len)) > DEASPLAY_RUN_MERGE)))
+            {
+                /* too far from the open run: flush it */
+                deasplay_hal_write_run(run_line, run_chr, run, run_len);
+                run_len = 0U;
+            }
+            if (run_len == 0U)
+            {
+                run_line = line;
+                run_chr = chr;
+            }
+            while ((run_chr + run_len) < chr)
+            {
+                /* unchanged elements in between: cheaper to send them again than a new command */
+                run[run_len] = display_buffer[i - (chr - (run_chr + run_len))].character_prev;
+                run_len++;
+            }
+            run[run_len] = c;
+            run_len++;
+#else
             deasplay_hal_set_cursor(line, chr);
-            deasplay_hal_write_char(display_buffer[i].character);
+            deasplay_hal_write_char(c);
+#endif
         }
         chr++;
         if (chr >= DEASPLAY_CHARS)
@@ -99,7 +298,134 @@ void display_periodic(void)
         }
     }
 
+#ifdef deasplay_hal_write_run
+    if (run_len != 0U)
+    {
+        deasplay_hal_write_run(run_line, run_chr, run, run_len);
+    }
+#endif
+
+#ifdef deasplay_hal_frame_end
+    deasplay_hal_frame_end();
+#endif
+
+}
+
+#ifdef DEASPLAY_BUS_STATS
+static void display_bus_add(t_display_bus_count *sum, const t_display_bus_count *count)
+{
+    sum->transactions += count->transactions;
+    sum->cgram += count->cgram;
+    sum->bits += count->bits;
+    sum->busy += count->busy;
+}
+
+/* Close the bus counters of a frame period, and of a second every DEASPLAY_FPS of them */
+static void display_bus_periodic(void)
+{
+    memset(&display_bus.frame, 0, sizeof(t_display_bus_count));
+#ifdef deasplay_hal_bus
+    deasplay_hal_bus(&display_bus.frame);
+#endif
+    display_bus_add(&display_bus.partial, &display_bus.frame);
+
+    display_bus.frames++;
+    if (display_bus.frames >= DEASPLAY_FPS)
+    {
+        display_bus.frames = 0U;
+        display_bus.second = display_bus.partial;
+        memset(&display_bus.partial, 0, sizeof(t_display_bus_count));
+    }
+    else
+    {
+        /* the second goes on */
+    }
+}
+#endif
+
+/**
+ * display_frame_periodic
+ *
+ * @brief Flush the display buffer at DEASPLAY_FPS, whatever the main
+ *        loop speed. A frame that is due while the caller is busy
+ *        is dropped: its changes go out with the next one.
+ * @param skip  true when the time is needed elsewhere (e.g. audio)
+ */
+void display_frame_periodic(bool skip)
+{
+    uint32_t now = DEASPLAY_TIMESTAMP;
+    bool late = false;
+
+#ifdef deasplay_hal_poll
+    /* keep the bus busy between the frames */
+    deasplay_hal_poll();
+#endif
+
+    if ((now - display_frames.timestamp) >= DEASPLAY_FRAME_US)
+    {
+        display_frames.timestamp += DEASPLAY_FRAME_US;
+        if ((now - display_frames.timestamp) >= DEASPLAY_FRAME_US)
+        {
+            /* late by more than a frame: re-synchronize */
+            display_frames.timestamp = now;
+            display_frames.dropped++;
+            late = true;
+        }
+        else
+        {
+            /* on time */
+        }
+
+        if (skip == true)
+        {
+            /* a frame both late and skipped is a single drop */
+            if (late == false) display_frames.dropped++;
+        }
+        else
+        {
+            display_periodic();
+            /* the controller shows these slots until the next flush */
+            display_glyphs.shown = display_glyph_mask();
+            display_glyphs.budget = DEASPLAY_GLYPH_BUDGET;
+            now = DEASPLAY_TIMESTAMP - now;
+            display_frames.time = (now > 0xFFFFU) ? 0xFFFFU : (uint16_t)now;
+            if (display_frames.time > display_frames.time_max) display_frames.time_max = display_frames.time;
+        }
+
+#ifdef DEASPLAY_BUS_STATS
+        display_bus_periodic();
+#endif
+    }
+    else
+    {
+        /* waiting for the next frame */
+    }
+}
+
+/**
+ * display_frame_stats
+ *
+ * @brief Get the frame scheduler counters (they can be reset through the pointer)
+ * @return the frame scheduler state
+ */
+t_display_frames* display_frame_stats(void)
+{
+    return &display_frames;
+}
+
+#ifdef DEASPLAY_BUS_STATS
+/**
+ * display_bus_stats
+ *
+ * @brief Get the display bus counters, per frame period and per second
+ *        (only the HAL with a bus count them: LC75710 and HD44780)
+ * @return the bus counters
+ */
+t_display_bus_stats* display_bus_stats(void)
+{
+    return &display_bus;
 }
+#endif
 
 void display_set_cursor(uint8_t line, uint8_t chr)
 {
@@ -127,11 +453,249 @@ void display_write_char(uint8_t chr)
 {
     /* add char to buffer */
     display_buffer[display_status.index].character = chr;
+    if (display_buffer[display_status.index].character_prev != chr) display_dirty_mark(display_status.index);
     /* advance the cursor */
     display_advance_cursor(1U);
 }
 
-void display_write_string(char *str)
+/**
+ * display_overlay
+ *
+ * @brief Show a string over the display buffer for a while. The base
+ *        layer keeps being written (e.g. by a meter) and shows again,
+ *        where it differs, when the overlay expires.
+ * @param line      overlay line
+ * @param chr       overlay first character
+ * @param str       the string, clipped at the end of the line
+ * @param duration  how long the overlay stays [us]
+ */
+void display_overlay(uint8_t line, uint8_t chr, const char *str, uint32_t duration)
+{
+    uint8_t len = 0U;
+
+    /* the old overlay might be larger */
+    display_overlay_clear();
+
+    while ((str[len] != '\0') && ((chr + len) < DEASPLAY_CHARS))
+    {
+        overlay_buffer[len] = (uint8_t)str[len];
+        len++;
+    }
+
+    display_overlay_state.first = (line * DEASPLAY_CHARS) + chr;
+    display_overlay_state.len = len;
+    display_overlay_state.timestamp = DEASPLAY_TIMESTAMP;
+    display_overlay_state.duration = duration;
+    display_dirty_range(display_overlay_state.first, len);
+}
+
+/**
+ * display_overlay_clear
+ *
+ * @brief Remove the overlay before it expires
+ */
+void display_overlay_clear(void)
+{
+    display_dirty_range(display_overlay_state.first, display_overlay_state.len);
+    display_overlay_state.len = 0U;
+}
+
+/**
+ * display_blink
+ *
+ * @brief Make characters blink, or stop them. The controllers with a
+ *        blink engine do it by themselves: no traffic per blink. The
+ *        others are refreshed by display_periodic() at every phase.
+ *        The characters keep the attribute whatever is written there.
+ * @param line      the line
+ * @param chr       the first character
+ * @param len       the number of characters
+ * @param period    blink period [ms], the same for the whole display
+ *                  (0: stop blinking the given characters)
+ */
+void display_blink(uint8_t line, uint8_t chr, uint8_t len, uint16_t period)
+{
+    uint32_t mask = 0U;
+
+    for (; (len > 0U) && (chr < DEASPLAY_CHARS); len--)
+    {
+        mask |= (1UL << chr);
+        chr++;
+    }
+
+    if (period != 0U)
+    {
+        display_blink_mask[line] |= mask;
+        if (display_blink_state.period != period)
+        {
+            display_blink_state.period = period;
+            display_blink_state.half = (uint32_t)period * 500UL;
+        }
+    }
+    else
+    {
+        display_blink_mask[line] &= ~mask;
+    }
+
+    display_blink_state.update = true;
+    /* the hidden characters show again */
+    display_dirty_range(line * DEASPLAY_CHARS, DEASPLAY_CHARS);
+}
+
+/**
+ * display_blink_clear
+ *
+ * @brief Stop every character blinking
+ */
+void display_blink_clear(void)
+{
+    uint8_t line;
+
+    for (line = 0U; line < DEASPLAY_LINES; line++)
+    {
+        display_blink_mask[line] = 0U;
+        display_dirty_range(line * DEASPLAY_CHARS, DEASPLAY_CHARS);
+    }
+    display_blink_state.update = true;
+}
+
+/**
+ * display_scroll
+ *
+ * @brief Scroll a line one character to the left. Single line displays
+ *        with a shift command do it in hardware: the refresh sends the
+ *        shift and the new character only, instead of the whole line.
+ * @param line  the line
+ * @param chr   the character entering on the right
+ */
+void display_scroll(uint8_t line, uint8_t chr)
+{
+    uint8_t first = line * DEASPLAY_CHARS;
+    uint8_t i;
+
+    for (i = first; i < (first + DEASPLAY_CHARS - 1U); i++)
+    {
+        display_buffer[i].character = display_buffer[i + 1U].character;
+#if defined(deasplay_hal_shift) && (DEASPLAY_LINES == 1U)
+        display_buffer[i].character_prev = display_buffer[i + 1U].character_prev;
+#endif
+    }
+    display_buffer[i].character = chr;
+
+#if defined(deasplay_hal_shift) && (DEASPLAY_LINES == 1U)
+    /* what the controller shows on the right is unknown: always send it */
+    display_buffer[i].character_prev = (uint8_t)~chr;
+    display_status.shift++;
+#endif
+
+    /* every element has moved: unchanged ones are not sent anyway */
+    display_dirty_range(first, DEASPLAY_CHARS);
+}
+
+/**
+ * display_marquee
+ *
+ * @brief Show a text on a line, scrolling it when it does not fit.
+ *        The steps are paced by display_periodic(): the start of the
+ *        text stays for DEASPLAY_MARQUEE_HOLD_US, then the text scrolls
+ *        endlessly, followed by DEASPLAY_MARQUEE_GAP spaces.
+ *        The marquee stops at the next display_clean() or display_clear().
+ * @param line      the line
+ * @param text      the text: it is read at every step, keep it in place
+ * @param period    time between the steps [us]
+ */
+void display_marquee(uint8_t line, const char *text, uint32_t period)
+{
+    uint8_t first = line * DEASPLAY_CHARS;
+    uint8_t len = 0U;
+
+    display_marquee_clear();
+
+    while ((len < DEASPLAY_CHARS) && (text[len] != '\0'))
+    {
+        display_buffer[first + len].character = (uint8_t)text[len];
+        len++;
+    }
+    display_dirty_range(first, len);
+
+    if (text[len] != '\0')
+    {
+        /* longer than the line: scroll it */
+        while ((len < 0xFFU) && (text[len] != '\0'))
+        {
+            len++;
+        }
+        display_marquee_state.line = line;
+        display_marquee_state.len = len;
+        display_marquee_state.next = DEASPLAY_CHARS;
+        display_marquee_state.timestamp = DEASPLAY_TIMESTAMP;
+        display_marquee_state.wait = DEASPLAY_MARQUEE_HOLD_US;
+        display_marquee_state.period = period;
+        display_marquee_state.text = text;
+    }
+    else
+    {
+        /* fits: nothing to scroll */
+    }
+}
+
+/**
+ * display_marquee_clear
+ *
+ * @brief Stop the marquee, the line keeps what it shows
+ */
+void display_marquee_clear(void)
+{
+    display_marquee_state.text = NULL;
+}
+
+/**
+ * display_glyph_define
+ *
+ * @brief Define a custom character (when the display supports them)
+ * @param slot  character code of the glyph
+ * @param rows  DEASPLAY_GLYPH_ROWS rows, top first, 5 columns each (bit 0 on the left)
+ */
+void display_glyph_define(uint8_t slot, const uint8_t *rows)
+{
+#ifdef deasplay_hal_glyph_define
+    deasplay_hal_glyph_define(slot, rows);
+#else
+    (void)slot;
+    (void)rows;
+#endif
+    if (display_glyphs.budget > 0U) display_glyphs.budget--;
+}
+
+/**
+ * display_glyph_budget
+ *
+ * @brief Custom glyph uploads left in this frame. display_glyph_define()
+ *        uses one up, the frame scheduler gives DEASPLAY_GLYPH_BUDGET back
+ *        at every flush: optional uploads (e.g. glyphs drawn on the fly)
+ *        wait when it is 0.
+ * @return the uploads left until the next flush
+ */
+uint8_t display_glyph_budget(void)
+{
+    return display_glyphs.budget;
+}
+
+/**
+ * display_glyph_busy
+ *
+ * @brief Custom glyph slots that must not be redefined now: the ones the
+ *        controller shows since the last flush (the new bitmap would land
+ *        before the characters of the next frame) and the ones the buffer
+ *        uses for the next frame.
+ * @return the busy slots, a bit each
+ */
+uint32_t display_glyph_busy(void)
+{
+    return display_glyphs.shown | display_glyph_mask();
+}
+
+void display_write_string(const char *str)
 {
     while (*str != '\0')
     {
@@ -154,18 +718,113 @@ void display_write_stringf(char *fmt, ...)
 #endif
 }
 
-void display_write_number(uint16_t number, bool leading_zeros)
+/* Digit weights of a 16 bit number */
+static const uint16_t display_weights[5] = { 10000U, 1000U, 100U, 10U, 1U };
+
+/* Write a number in the given format: the digits are found by
+ * subtracting their weight, without any division */
+static void display_format(uint16_t number, char sign, uint8_t decimals, uint8_t format, const char *unit)
 {
-    bool not_zero = false;
-    uint8_t tmp;
-    uint16_t i = 10000U;
+    uint8_t digits[5];
+    uint8_t first = 0U;
+    uint8_t len;
+    uint8_t pad = 0U;
+    uint8_t i;
+
+    if (decimals > 4U) decimals = 4U;
+
+    for (i = 0U; i < 5U; i++)
+    {
+        digits[i] = (uint8_t)'0';
+        while (number >= display_weights[i])
+        {
+            number -= display_weights[i];
+            digits[i]++;
+        }
+    }
+
+    /* no leading zeros, the units are always shown */
+    while ((first < (4U - decimals)) && (digits[first] == (uint8_t)'0'))
+    {
+        first++;
+    }
 
-    do
+    len = (5U - first) + ((decimals != 0U) ? 1U : 0U) + ((sign != '\0') ? 1U : 0U);
+    for (i = 0U; (unit != NULL) && (unit[i] != '\0'); i++)
     {
-        tmp = (number / i) % 10U;
-        if ((leading_zeros == true) || (tmp != 0U) || (i == 1U)) not_zero = true;
-        if (not_zero == true) display_write_char('0' + tmp);
-        i /= 10U;
-    } while(i != 0U);
+        len++;
+    }
+    if ((format & DEASPLAY_WIDTH_MASK) > len) pad = (format & DEASPLAY_WIDTH_MASK) - len;
 
+    if ((format & (DEASPLAY_ALIGN_RIGHT | DEASPLAY_PAD_ZEROS)) == DEASPLAY_ALIGN_RIGHT)
+    {
+        for (; pad > 0U; pad--) display_write_char(' ');
+    }
+    if (sign != '\0') display_write_char((uint8_t)sign);
+    if ((format & DEASPLAY_ALIGN_RIGHT) != 0U)
+    {
+        /* zeros after the sign */
+        for (; pad > 0U; pad--) display_write_char('0');
+    }
+
+    for (i = first; i < 5U; i++)
+    {
+        if (i == (5U - decimals)) display_write_char('.');
+        display_write_char(digits[i]);
+    }
+
+    if (unit != NULL) display_write_string(unit);
+
+    /* left aligned: fill the field */
+    for (; pad > 0U; pad--) display_write_char(' ');
+}
+
+/**
+ * display_write_number
+ *
+ * @brief Write a number at the cursor position
+ * @param number        the number
+ * @param leading_zeros true: always 5 digits
+ */
+void display_write_number(uint16_t number, bool leading_zeros)
+{
+    display_format(number, '\0', 0U, (leading_zeros == true) ? (5U | DEASPLAY_ALIGN_RIGHT | DEASPLAY_PAD_ZEROS) : 0U, NULL);
+}
+
+/**
+ * display_write_unsigned
+ *
+ * @brief Write an unsigned fixed point number at the cursor position,
+ *        e.g. 1234 with 1 decimal and unit "Hz" gives "123.4Hz"
+ * @param number    the number, in units of the last decimal
+ * @param decimals  digits after the decimal point (0 to 4)
+ * @param format    field width and DEASPLAY_ALIGN_RIGHT, DEASPLAY_PAD_ZEROS flags
+ * @param unit      suffix (NULL: none)
+ */
+void display_write_unsigned(uint16_t number, uint8_t decimals, uint8_t format, const char *unit)
+{
+    display_format(number, ((format & DEASPLAY_SIGN) != 0U) ? '+' : '\0', decimals, format, unit);
+}
+
+/**
+ * display_write_value
+ *
+ * @brief Write a signed fixed point number at the cursor position,
+ *        e.g. -23 with DEASPLAY_SIGN and unit "dB" gives "-23dB"
+ * @param value     the number, in units of the last decimal
+ * @param decimals  digits after the decimal point (0 to 4)
+ * @param format    field width and DEASPLAY_ALIGN_RIGHT, DEASPLAY_PAD_ZEROS,
+ *                  DEASPLAY_SIGN flags
+ * @param unit      suffix (NULL: none)
+ */
+void display_write_value(int16_t value, uint8_t decimals, uint8_t format, const char *unit)
+{
+    if (value < 0)
+    {
+        display_format((uint16_t)0U - (uint16_t)value, '-', decimals, format, unit);
+    }
+    else
+    {
+        display_write_unsigned((uint16_t)value, decimals, format, unit);
+    }
 }
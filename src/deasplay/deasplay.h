@@ -32,6 +32,27 @@
 
 #define DEASPLAY_VERSION        0x0100U   /**< Version 1.0 */
 
+#ifndef DEASPLAY_FPS
+#define DEASPLAY_FPS            30U       /**< Frame rate of display_frame_periodic() */
+#endif
+#define DEASPLAY_FRAME_US       (1000000UL / DEASPLAY_FPS)    /**< Frame period [us] */
+#define DEASPLAY_GLYPH_ROWS     7U        /**< Rows of a custom glyph (5 columns, bit 0 on the left) */
+#ifndef DEASPLAY_GLYPH_BUDGET
+#define DEASPLAY_GLYPH_BUDGET   4U        /**< Custom glyph uploads per frame, see display_glyph_budget() */
+#endif
+#ifndef DEASPLAY_MARQUEE_HOLD_US
+#define DEASPLAY_MARQUEE_HOLD_US    1000000UL /**< The start of a marquee text stays before scrolling [us] */
+#endif
+#ifndef DEASPLAY_MARQUEE_GAP
+#define DEASPLAY_MARQUEE_GAP        3U        /**< Spaces between the end of a marquee text and its start */
+#endif
+
+/* Number formats (display_write_unsigned(), display_write_value()) */
+#define DEASPLAY_WIDTH_MASK     0x0FU     /**< Field width, sign and unit included (0: as long as needed) */
+#define DEASPLAY_ALIGN_RIGHT    0x10U     /**< Right aligned in the field (default: left aligned) */
+#define DEASPLAY_PAD_ZEROS      0x20U     /**< Right aligned: zeros before the digits instead of spaces */
+#define DEASPLAY_SIGN           0x40U     /**< '+' before the values greater than or equal to zero */
+
 /**< Power states enumeration */
 typedef enum
 {
@@ -42,7 +63,10 @@ typedef enum
 /**< The structure to hold the display state */
 typedef struct
 {
-    uint8_t index;     /**< Selected line and character */
+    uint8_t index;          /**< Selected line and character */
+    uint8_t dirty_first;    /**< First element that might need a redraw */
+    uint8_t dirty_last;     /**< Last element that might need a redraw (none if lower than dirty_first) */
+    uint8_t shift;          /**< Display shifts to send with the next refresh */
 } t_display_status;
 
 /**< The structure holds the state of a single display element (i.e. a character) */
@@ -52,18 +76,100 @@ typedef struct
     uint8_t character_prev;     /**< Last active character */
 } t_display_elem;
 
+/**< Frame scheduler state and counters */
+typedef struct
+{
+    uint32_t timestamp;     /**< Start of the current frame period */
+    uint16_t time;          /**< Duration of the last frame flush [us] */
+    uint16_t time_max;      /**< Longest frame flush [us] */
+    uint16_t dropped;       /**< Frames skipped or missed */
+} t_display_frames;
+
+/**< Custom glyph slots, as seen by the frame scheduler */
+typedef struct
+{
+    uint32_t shown;         /**< Slots used by the last flushed frame, a bit each */
+    uint8_t  budget;        /**< Uploads left until the next flush */
+} t_display_glyphs;
+
+/**< Display bus traffic, counted by the HAL (DEASPLAY_BUS_STATS) */
+typedef struct
+{
+    uint16_t transactions;  /**< Commands sent to the controller */
+    uint16_t cgram;         /**< Custom glyph uploads */
+    uint32_t bits;          /**< Bits clocked out */
+    uint32_t busy;          /**< Time spent waiting for the controller [us] */
+} t_display_bus_count;
+
+/**< Display bus counters, gathered by display_frame_periodic() */
+typedef struct
+{
+    t_display_bus_count frame;      /**< Traffic of the last frame period */
+    t_display_bus_count second;     /**< Traffic of the last second */
+    t_display_bus_count partial;    /**< Traffic of the current second, up to the last frame */
+    uint8_t  frames;                /**< Frame periods in partial */
+} t_display_bus_stats;
+
+/**< Transient layer drawn over the display buffer */
+typedef struct
+{
+    uint8_t  first;         /**< First element covered */
+    uint8_t  len;           /**< Elements covered (0: no overlay) */
+    uint32_t timestamp;     /**< When the overlay has been shown */
+    uint32_t duration;      /**< How long it stays [us] */
+} t_display_overlay;
+
+/**< Text scrolling through a line, one character at a time */
+typedef struct
+{
+    const char *text;       /**< The text (NULL: no marquee) */
+    uint8_t  line;          /**< Line scrolled */
+    uint8_t  len;           /**< Text length */
+    uint8_t  next;          /**< Next character entering on the right (text, then gap) */
+    uint32_t timestamp;     /**< Last step */
+    uint32_t wait;          /**< Time to the next step [us] */
+    uint32_t period;        /**< Step period [us] */
+} t_display_marquee;
+
+/**< Blink attribute state */
+typedef struct
+{
+    uint16_t period;        /**< Blink period [ms] (0: not blinking) */
+    uint32_t half;          /**< Half period [us], software blinking */
+    uint32_t timestamp;     /**< Last phase change, software blinking */
+    bool     off;           /**< Blinking characters hidden, software blinking */
+    bool     update;        /**< Attributes to send to the controller */
+} t_display_blink;
+
 /* Display APIs */
 void display_init(void);
 void display_power(e_deasplay_power state);
 void display_clear(void);
 void display_clean(void);
 void display_periodic(void);
+void display_frame_periodic(bool skip);
+t_display_frames* display_frame_stats(void);
+#ifdef DEASPLAY_BUS_STATS
+t_display_bus_stats* display_bus_stats(void);
+#endif
 void display_set_cursor(uint8_t line, uint8_t chr);
 void display_enable_cursor(bool visible);
 void display_advance_cursor(uint8_t num);
 void display_write_char(uint8_t chr);
-void display_write_string(char *str);
+void display_write_string(const char *str);
 void display_write_number(uint16_t number, bool leading_zeros);
+void display_write_unsigned(uint16_t number, uint8_t decimals, uint8_t format, const char *unit);
+void display_write_value(int16_t value, uint8_t decimals, uint8_t format, const char *unit);
+void display_overlay(uint8_t line, uint8_t chr, const char *str, uint32_t duration);
+void display_overlay_clear(void);
+void display_blink(uint8_t line, uint8_t chr, uint8_t len, uint16_t period);
+void display_blink_clear(void);
+void display_scroll(uint8_t line, uint8_t chr);
+void display_marquee(uint8_t line, const char *text, uint32_t period);
+void display_marquee_clear(void);
+void display_glyph_define(uint8_t slot, const uint8_t *rows);
+uint8_t display_glyph_budget(void);
+uint32_t display_glyph_busy(void);
 
 #ifdef DISPLAY_HAS_PRINTF
 void display_write_stringf(char *fmt, ...);
@@ -30,24 +30,82 @@
 #include <stdint.h>
 
 #if defined(DEASPLAY_HD44780)
-#error "Not implemented yet!"
+
+#include "driver/HD44780/hd44780_hal.h"
+
+#define DEASPLAY_LINES      HD44780_LINES
+#define DEASPLAY_CHARS      HD44780_CHARS
+#define DEASPLAY_GLYPHS     HD44780_CGRAM_SIZE      /**< Custom characters: codes 0 to DEASPLAY_GLYPHS - 1 */
+
+#define deasplay_hal_init               hd44780_display_hal_init
+#define deasplay_hal_power              hd44780_display_hal_power
+#define deasplay_hal_set_cursor         hd44780_display_hal_set_cursor
+#define deasplay_hal_write_char         hd44780_display_hal_write_char
+#define deasplay_hal_write_run          hd44780_display_hal_write_run
+#define deasplay_hal_glyph_define       hd44780_display_hal_glyph_define
+#define deasplay_hal_cursor_visibility  hd44780_display_hal_cursor_visibility
+#ifdef DEASPLAY_BUS_STATS
+#define deasplay_hal_bus                hd44780_display_hal_bus
+#endif
+
 #elif defined(DEASPLAY_LC75710)
 
+#include "driver/LC75710/lc75710.h"
 #include "driver/LC75710/lc75710_hal.h"
 
 #define DEASPLAY_LINES      LC75710_LINES
 #define DEASPLAY_CHARS      LC75710_CHARS
+#define DEASPLAY_GLYPHS     LC75710_CGRAM_SIZE
 
 #define deasplay_hal_init               lc75710_display_hal_init
 #define deasplay_hal_power              lc75710_display_hal_power
 #define deasplay_hal_set_cursor         lc75710_display_hal_set_cursor
 #define deasplay_hal_write_char         lc75710_display_hal_write_char
+#define deasplay_hal_write_run          lc75710_display_hal_write_run     /**< Optional: consecutive characters of a line */
 #define deasplay_hal_cursor_visibility  lc75710_display_hal_cursor_visibility
+#define deasplay_hal_poll               lc75710_display_hal_poll          /**< Optional: drains a non-blocking bus */
+#define deasplay_hal_glyph_define       lc75710_display_hal_glyph_define  /**< Optional: custom characters */
+#define deasplay_hal_shift              lc75710_display_hal_shift         /**< Optional: shifts a single line display to the left */
+#define deasplay_hal_blink              lc75710_display_hal_blink         /**< Optional: blink engine of the controller */
+#ifdef DEASPLAY_BUS_STATS
+#define deasplay_hal_bus                lc75710_display_hal_bus           /**< Optional: bus traffic counters (see display_bus_stats()) */
+#endif
 
 #elif defined(DEASPLAY_UART)
-#error "Not implemented yet!"
+
+#include "driver/UART/uart_hal.h"
+
+#define DEASPLAY_LINES      UART_DISPLAY_LINES
+#define DEASPLAY_CHARS      UART_DISPLAY_CHARS
+#define DEASPLAY_GLYPHS     UART_DISPLAY_GLYPHS
+
+#define deasplay_hal_init               uart_display_hal_init
+#define deasplay_hal_power              uart_display_hal_power
+#define deasplay_hal_set_cursor         uart_display_hal_set_cursor
+#define deasplay_hal_write_char         uart_display_hal_write_char
+#define deasplay_hal_write_run          uart_display_hal_write_run
+#define deasplay_hal_glyph_define       uart_display_hal_glyph_define
+#define deasplay_hal_frame_end          uart_display_hal_frame_end        /**< Optional: end of a display_periodic() refresh */
+#define deasplay_hal_cursor_visibility  uart_display_hal_cursor_visibility
+
 #elif defined(DEASPLAY_NCURSES)
-#error "Not implemented yet!"
+
+#include "driver/NCURSES/ncurses_hal.h"
+
+#define DEASPLAY_LINES      NCURSES_DISPLAY_LINES
+#define DEASPLAY_CHARS      NCURSES_DISPLAY_CHARS
+#define DEASPLAY_GLYPHS     NCURSES_DISPLAY_GLYPHS
+
+#define deasplay_hal_init               ncurses_display_hal_init
+#define deasplay_hal_power              ncurses_display_hal_power
+#define deasplay_hal_set_cursor         ncurses_display_hal_set_cursor
+#define deasplay_hal_write_char         ncurses_display_hal_write_char
+#define deasplay_hal_write_run          ncurses_display_hal_write_run
+#define deasplay_hal_glyph_define       ncurses_display_hal_glyph_define
+#define deasplay_hal_frame_begin        ncurses_display_hal_frame_begin   /**< Optional: start of a display_periodic() refresh */
+#define deasplay_hal_frame_end          ncurses_display_hal_frame_end
+#define deasplay_hal_poll               ncurses_display_hal_poll
+#define deasplay_hal_cursor_visibility  ncurses_display_hal_cursor_visibility
 #else
 #error "Please define a display driver."
 #endif
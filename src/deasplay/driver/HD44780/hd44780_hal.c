@@ -1,3 +1,30 @@
+/*
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+    Lorenzo Miori (C) 2016 [ 3M4|L: memoryS60<at>gmail.com ]
+
+    Version History
+        * 1.0 initial
+
+*/
+
+/**
+ * @file hd44780_hal.c
+ * @author Lorenzo Miori
+ * @date Oct 2016
+ * @brief Display HAL to interface the APIs to an HD44780 LCD (see hd44780_hal.h)
+ */
 
 #include "../../deasplay.h"
 #include "../../configuration.h"
@@ -5,7 +32,6 @@
 #ifdef DEASPLAY_HD44780
 
 #include <avr/io.h>
-#include <util/delay.h>
 
 #define SHIFT_LATCH_PIN     PIN3   /**< STCP 74HC595 PIN */
 #define SHIFT_CLOCK_PIN     PIN4   /**< SHCP 74HC595 PIN */
@@ -79,6 +105,10 @@ static uint8_t hd44780_virtual_port = 0U;
 
 static uint8_t lcd_displayparams;
 
+#ifdef DEASPLAY_BUS_STATS
+static t_display_bus_count bus;     /**< Traffic since the last collection (busy in TIMER2 ticks) */
+#endif
+
 static void shift_init(void)
 {
     SHIFT_DDR |= (1 << SHIFT_LATCH_PIN);
@@ -86,63 +116,140 @@ static void shift_init(void)
     SHIFT_DDR |= (1 << SHIFT_DATA_PIN);
 }
 
+/*
+ * One bit, unrolled: DS is written together with SHCP low by a single "out"
+ * (both port values are computed once per transfer), then SHCP rises with "sbi".
+ */
+#define SHIFT_OUT_BIT(n)    SHIFT_PORT = ((data & (1U << (n))) != 0U) ? high : low; \
+                            SHIFT_CLOCK_HIGH
+
 static void shift_out(void)
 {
-    uint8_t i;
-    /* Do not transfer the temporary register to the outputs */
+    uint8_t data = HD44780_PORT;
+    uint8_t low;
+    uint8_t high;
+
+#ifdef DEASPLAY_BUS_STATS
+    bus.bits += 8U;
+#endif
+
+    /* Do not transfer the temporary register to the outputs:
+     * latch and clock low, the keypad pull-ups on the same port are kept */
+    low = SHIFT_PORT & (uint8_t)~((1 << SHIFT_LATCH_PIN) | (1 << SHIFT_CLOCK_PIN) | (1 << SHIFT_DATA_PIN));
+    high = low | (1 << SHIFT_DATA_PIN);
+
+    /* Shift bits out (virtual port bit 0 first, it ends up on Q7) */
+    SHIFT_OUT_BIT(0);
+    SHIFT_OUT_BIT(1);
+    SHIFT_OUT_BIT(2);
+    SHIFT_OUT_BIT(3);
+    SHIFT_OUT_BIT(4);
+    SHIFT_OUT_BIT(5);
+    SHIFT_OUT_BIT(6);
+    SHIFT_OUT_BIT(7);
     SHIFT_CLOCK_LOW;
+
+    /* Transfer the temporary register to the outputs */
+    SHIFT_LATCH_HIGH;
     SHIFT_LATCH_LOW;
 
-    for (i = 0; i < 8; i++)
+}
+
+/* Busy guard: TIMER2 free-running at F_CPU/128, restarted after every command.
+ * Its overflow flag covers the (long) times in between. */
+#define HD44780_TIMER_DIV       128UL
+#define HD44780_TICKS(us)       (((((F_CPU / HD44780_TIMER_DIV) * (us)) + 999999UL) / 1000000UL) + 1U)
+#define HD44780_TICKS_MS(ms)    ((((F_CPU / HD44780_TIMER_DIV) * (ms)) / 1000UL) + 1U)
+#define HD44780_GUARD_MAX       200U                        /**< Longest guard [ticks], below the overflow */
+#define HD44780_TICKS_US(ticks) (((ticks) * HD44780_TIMER_DIV) / (F_CPU / 1000000UL))
+
+#define HD44780_POWER_ON_MS     150UL       /**< More than 40ms after Vcc rises to 2.7V */
+#define HD44780_RESET_US        4100UL      /**< After the first 8 bit function set */
+#define HD44780_RESET_NEXT_US   100UL       /**< After the second one */
+
+#if (HD44780_TICKS(HD44780_HOME_US) > HD44780_GUARD_MAX)
+#error "The HD44780 execution times do not fit in the guard timer"
+#endif
+
+static uint8_t guard_ticks = 0U;            /**< Ticks of the running guard */
+static uint8_t address = 0U;                /**< DDRAM address counter */
+
+static void hd44780_guard_start(uint8_t ticks)
+{
+    TCNT2 = 0U;
+    TIFR = (1 << TOV2);     /* writing one clears the flag */
+    guard_ticks = ticks;
+}
+
+static void hd44780_guard_wait(void)
+{
+#ifdef DEASPLAY_BUS_STATS
+    uint8_t ticks = TCNT2;
+
+    /* the loop below lasts until the end of the guard */
+    if (((TIFR & (1 << TOV2)) == 0U) && (ticks < guard_ticks))
     {
-        /* Shift bits out */
-        if (((HD44780_PORT >> i) & 0x01U) == 0x01U)
-        {
-            SHIFT_DATA_HIGH;
-        }
-        else
-        {
-            SHIFT_DATA_LOW;
-        }
-        /* Clocks the bits */
-        SHIFT_CLOCK_HIGH;
-        SHIFT_CLOCK_LOW;
+        bus.busy += guard_ticks - ticks;
     }
+#endif
 
-    /* Transfer the temporary register to the outputs */
-    SHIFT_LATCH_HIGH;
-    SHIFT_LATCH_LOW;
+    while (((TIFR & (1 << TOV2)) == 0U) && (TCNT2 < guard_ticks))
+    {
+        /* the controller is still busy */
+    }
+}
 
+/* Blocking wait, for the init sequence only */
+static void hd44780_sleep(uint16_t ticks)
+{
+    hd44780_guard_wait();
+    while (ticks > HD44780_GUARD_MAX)
+    {
+        hd44780_guard_start(HD44780_GUARD_MAX);
+        hd44780_guard_wait();
+        ticks -= HD44780_GUARD_MAX;
+    }
+    hd44780_guard_start((uint8_t)ticks);
+    hd44780_guard_wait();
 }
 
+/*
+ * A nibble takes two loads of the shift register: the data with EN high, then
+ * the same data with EN low. The controller samples on the falling edge, so
+ * the data only needs to be stable from the first load to the second one.
+ */
 static void hd44780_write_nibble(uint8_t nibble)
 {
-    /* Set DATA in the virtual port */
-    HD44780_PORT = (HD44780_PORT & ~(0x0f << HD44780_D4)) | ((nibble & 0x0f) << HD44780_D4);
+    /* Set DATA in the virtual port, ENABLE rises */
+    HD44780_PORT = (HD44780_PORT & ~(0x0f << HD44780_D4)) | ((nibble & 0x0f) << HD44780_D4) | (1 << HD44780_EN);
     shift_out();
 
-    /* Clocks the ENABLE */
-    HD44780_PORT &= ~(1 << HD44780_EN);
-    shift_out();
-    HD44780_PORT |= (1 << HD44780_EN);
-    shift_out();
+    /* ENABLE falls: the nibble is latched */
     HD44780_PORT &= ~(1 << HD44780_EN);
     shift_out();
-    //_delay_us(1);   /* adjust if needed! */
 }
 
-static void hd44780_transmit(uint8_t data, uint8_t tx_mode)
+static void hd44780_transmit(uint8_t data, uint8_t tx_mode, uint8_t ticks)
 {
+    uint8_t rs = (tx_mode == MODE_WRITE_DATA) ? (1 << HD44780_RS) : 0U;
+
+    /* the previous command must have completed */
+    hd44780_guard_wait();
 
-    if (tx_mode)
+#ifdef DEASPLAY_BUS_STATS
+    bus.transactions++;
+#endif
+
+    if ((HD44780_PORT & (1 << HD44780_RS)) != rs)
     {
-        HD44780_PORT |= (1 << HD44780_RS);
+        /* RS has to settle before ENABLE rises: one more load, only when it changes */
+        HD44780_PORT ^= (1 << HD44780_RS);
+        shift_out();
     }
     else
     {
-        HD44780_PORT &= ~(1 << HD44780_RS);
+        /* same register as before (e.g. a run of characters) */
     }
-    shift_out();
 
     /* RW pin is always tied to GND in this implementation
      * (no need to pull it low here) */
@@ -151,49 +258,65 @@ static void hd44780_transmit(uint8_t data, uint8_t tx_mode)
     hd44780_write_nibble(data >> 4U);
     hd44780_write_nibble(data);
 
+    /* the command executes now: the next one checks the guard */
+    hd44780_guard_start(ticks);
+
 }
 
 static void hd44780_write_command(uint8_t cmd)
 {
-    hd44780_transmit(cmd, MODE_WRITE_COMMAND);
+    hd44780_transmit(cmd, MODE_WRITE_COMMAND, HD44780_TICKS(HD44780_EXECUTE_US));
 }
 
 static void hd44780_write_data(uint8_t data)
 {
-    hd44780_transmit(data, MODE_WRITE_DATA);
+    hd44780_transmit(data, MODE_WRITE_DATA, HD44780_TICKS(HD44780_EXECUTE_US));
+    address++;
+}
+
+static void hd44780_set_address(uint8_t line, uint8_t chr)
+{
+    /* lines 2 and 3 continue lines 0 and 1 in the DDRAM (e.g. 20x4 modules) */
+    address = (((line & 0x1U) != 0U) ? 0x40U : 0x00U) + ((line >> 1) * HD44780_CHARS) + chr;
+    hd44780_write_command(HD44780_SETDDRAMADDR | address);
 }
 
-void hd44780_init(void)
+static void hd44780_init(void)
 {
 
-    /* Wait for more than 15ms when Vcc raises to 4.5V */
-    _delay_ms(150);
+    /* Busy guard timer: F_CPU/128 */
+    TCCR2 = (1 << CS22) | (1 << CS20);
 
+    /* Wait for more than 40ms when Vcc raises to 2.7V */
     HD44780_PORT = 0U;
     shift_out();
-    _delay_ms(5);
+    hd44780_sleep(HD44780_TICKS_MS(HD44780_POWER_ON_MS));
 
     /* Follow initialization sequence from the datasheet */
 
-    /* Select 4 bit mode */
+    /* Function set: 8 bit mode, whatever the current state */
     hd44780_write_nibble(0x03U);
-    _delay_ms(5);
-    /* Select 4 bit mode (again) */
+    hd44780_sleep(HD44780_TICKS(HD44780_RESET_US));
+    /* (again) */
     hd44780_write_nibble(0x03U);
-    _delay_ms(5);
-    /* Select 4 bit mode (again) */
+    hd44780_sleep(HD44780_TICKS(HD44780_RESET_NEXT_US));
+    /* (again) */
     hd44780_write_nibble(0x03U);
-    _delay_ms(5);
+    hd44780_sleep(HD44780_TICKS(HD44780_EXECUTE_US));
 
-    /* Select 8 bit mode (this could be a specific init sequence, it
-     * is quite strange to select 8bit command here :-) ) */
+    /* Select 4 bit mode: from now on, every byte is sent as 2 nibbles */
     hd44780_write_nibble(0x02U);
+    hd44780_sleep(HD44780_TICKS(HD44780_EXECUTE_US));
 
-    hd44780_write_command(HD44780_FUNCTIONSET | HD44780_4BITMODE | HD44780_2LINE | HD44780_5x8DOTS);
+    hd44780_write_command(HD44780_FUNCTIONSET | HD44780_4BITMODE | HD44780_5x8DOTS |
+                          ((HD44780_LINES > 1U) ? HD44780_2LINE : HD44780_1LINE));
 
     lcd_displayparams = HD44780_CURSOROFF | HD44780_BLINKOFF | HD44780_DISPLAYON;
     hd44780_write_command(HD44780_DISPLAYCONTROL | lcd_displayparams);
 
+    /* Runs of characters need the address to increment */
+    hd44780_write_command(HD44780_ENTRYMODESET | HD44780_ENTRYLEFT | HD44780_ENTRYSHIFTDECREMENT);
+
 }
 
 void hd44780_display_hal_init(void)
@@ -205,22 +328,32 @@ void hd44780_display_hal_init(void)
 
     /* Initialize the HD44780 chipset and LCD */
     hd44780_init();
-    hd44780_write_command(HD44780_CLEARDISPLAY);
-    _delay_ms(2);
-    hd44780_write_command(HD44780_RETURNHOME);
-    _delay_ms(2);
+    hd44780_transmit(HD44780_CLEARDISPLAY, MODE_WRITE_COMMAND, HD44780_TICKS(HD44780_HOME_US));
+    address = 0U;
 }
 
-void hd44780_display_hal_set_cursor(uint8_t line, uint8_t chr)
+void hd44780_display_hal_power(e_deasplay_power state)
 {
-    static uint8_t offsets[] = { 0x00, 0x40 };
+    if (state == DEASPLAY_POWER_ON)
+    {
+        lcd_displayparams |= HD44780_DISPLAYON;
+    }
+    else
+    {
+        lcd_displayparams &= ~HD44780_DISPLAYON;
+    }
 
-    if (line > 1)
+    hd44780_write_command(HD44780_DISPLAYCONTROL | lcd_displayparams);
+}
+
+void hd44780_display_hal_set_cursor(uint8_t line, uint8_t chr)
+{
+    if (line >= HD44780_LINES)
     {
-      line = 1;
+        line = HD44780_LINES - 1U;
     }
 
-    hd44780_write_command(HD44780_SETDDRAMADDR | (chr + offsets[line]));
+    hd44780_set_address(line, chr);
 }
 
 void hd44780_display_hal_write_char(uint8_t chr)
@@ -228,6 +361,67 @@ void hd44780_display_hal_write_char(uint8_t chr)
     hd44780_write_data(chr);
 }
 
+void hd44780_display_hal_write_run(uint8_t line, uint8_t chr, uint8_t *data, uint8_t len)
+{
+    uint8_t i;
+
+    /* one address command, the controller increments it */
+    hd44780_set_address(line, chr);
+    for (i = 0; i < len; i++)
+    {
+        hd44780_write_data(data[i]);
+    }
+}
+
+void hd44780_display_hal_glyph_define(uint8_t slot, const uint8_t *rows)
+{
+    uint8_t i;
+    uint8_t row;
+    uint8_t dots;
+    uint8_t resume = address;
+
+    if (slot < HD44780_CGRAM_SIZE)
+    {
+        hd44780_write_command(HD44780_SETCGRAMADDR | (slot << 3));
+        for (i = 0; i < 8U; i++)
+        {
+            /* the leftmost column is bit 4 here, the 8th row is the cursor line */
+            row = (i < DEASPLAY_GLYPH_ROWS) ? rows[i] : 0U;
+            dots = 0U;
+            if ((row & 0x01U) != 0U) dots |= 0x10U;
+            if ((row & 0x02U) != 0U) dots |= 0x08U;
+            if ((row & 0x04U) != 0U) dots |= 0x04U;
+            if ((row & 0x08U) != 0U) dots |= 0x02U;
+            if ((row & 0x10U) != 0U) dots |= 0x01U;
+            hd44780_transmit(dots, MODE_WRITE_DATA, HD44780_TICKS(HD44780_EXECUTE_US));
+        }
+
+        /* back to the characters */
+        address = resume;
+        hd44780_write_command(HD44780_SETDDRAMADDR | address);
+
+#ifdef DEASPLAY_BUS_STATS
+        bus.cgram++;
+#endif
+    }
+    else
+    {
+        /* no such slot */
+    }
+}
+
+#ifdef DEASPLAY_BUS_STATS
+void hd44780_display_hal_bus(t_display_bus_count *count)
+{
+    /* hand over what went out since the last call */
+    count->transactions += bus.transactions;
+    count->bits += bus.bits;
+    count->busy += HD44780_TICKS_US(bus.busy);
+    count->cgram += bus.cgram;
+    memset(&bus, 0, sizeof(t_display_bus_count));
+}
+#endif
+
 void hd44780_display_hal_cursor_visibility(bool visible)
 {
     if (visible == true)
@@ -244,4 +438,3 @@ void hd44780_display_hal_cursor_visibility(bool visible)
 }
 
 #endif  /* DEASPLAY_HD44780 */
-
@@ -20,24 +20,42 @@
 */
 
 /**
- * @file lc75710_hal.c
+ * @file hd44780_hal.h
  * @author Lorenzo Miori
- * @date Aug 2016
- * @brief Display HAL to interface the APIs to the LC75710
+ * @date Oct 2016
+ * @brief Display HAL to interface the APIs to an HD44780 LCD, driven in
+ *        4 bit mode through a 74HC595 shift register (RW tied to GND).
+ *
+ * Command execution times are tracked by TIMER2 (F_CPU/128), so the
+ * caller keeps running while the controller is busy.
+ * TIMER2 is also used by the LC75710 driver: only one can be built.
  */
 
-#ifndef SRC_DEASPLAY_DRIVER_LC75710_LC75710_HAL_H_
-#define SRC_DEASPLAY_DRIVER_LC75710_LC75710_HAL_H_
+#ifndef SRC_DEASPLAY_DRIVER_HD44780_HD44780_HAL_H_
+#define SRC_DEASPLAY_DRIVER_HD44780_HD44780_HAL_H_
 
 #include "../../deasplay.h"
 
-#define LC75710_LINES        1U     /**< Number of lines */
-#define LC75710_CHARS       10U     /**< Number of character per lines */
+#ifndef HD44780_LINES
+#define HD44780_LINES            2U     /**< Number of lines (1 to 4) */
+#endif
+#ifndef HD44780_CHARS
+#define HD44780_CHARS           16U     /**< Number of character per lines */
+#endif
+#define HD44780_CGRAM_SIZE       8U     /**< Custom characters (codes 0 to 7) */
+
+#define HD44780_EXECUTE_US      37U     /**< Execution time of most of the commands */
+#define HD44780_HOME_US       1520U     /**< Execution time of clear and return home */
 
 void hd44780_display_hal_init(void);
 void hd44780_display_hal_power(e_deasplay_power state);
 void hd44780_display_hal_set_cursor(uint8_t line, uint8_t chr);
 void hd44780_display_hal_write_char(uint8_t chr);
+void hd44780_display_hal_write_run(uint8_t line, uint8_t chr, uint8_t *data, uint8_t len);
+void hd44780_display_hal_glyph_define(uint8_t slot, const uint8_t *rows);
 void hd44780_display_hal_cursor_visibility(bool visible);
+#ifdef DEASPLAY_BUS_STATS
+void hd44780_display_hal_bus(t_display_bus_count *count);
+#endif
 
-#endif /* SRC_DEASPLAY_DRIVER_LC75710_LC75710_HAL_H_ */
+#endif /* SRC_DEASPLAY_DRIVER_HD44780_HD44780_HAL_H_ */
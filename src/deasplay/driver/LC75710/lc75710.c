@@ -52,6 +52,8 @@
                                          It can be reassigned by define'ing them at program's implementation, right before the include directive */
 #endif
 
+#if (LC75710_SPI == 0)
+
 #ifndef LC75710_DI
 #define LC75710_DI              PD3   /**< Serial Data Input pin.
                                          It can be reassigned by define'ing them at program's implementation, right before the include directive */
@@ -62,59 +64,192 @@
                                          It can be reassigned by define'ing them at program's implementation, right before the include directive */
 #endif
 
+#else
+
+/*
+ * Hardware SPI pins (fixed on the ATmega8):
+ *   MOSI (PB3) -> DI
+ *   SCK  (PB5) -> CL
+ *   SS   (PB2)    must stay high (or be an output) in master mode:
+ *                 when it is pulled low the SPI falls back to slave mode
+ *                 (KEY_3 sits on PB2 in manage_audio.c: the build stops until it moves)
+ *   MISO (PB4)    not used, free for GPIO
+ * CE is still driven by software (LC75710_CE, on LC75710_PORT).
+ */
+#define LC75710_SPI_DDR         DDRB
+#define LC75710_SPI_MOSI        PB3
+#define LC75710_SPI_SCK         PB5
+
+/* Serial clock: the LC75710 needs at least 160ns of CL high and low time */
+#ifndef LC75710_SPI_CLOCK_DIV
+#define LC75710_SPI_CLOCK_DIV   4U      /**< SCK = F_CPU / 4 (3MHz at 12MHz) */
+#endif
+
+#if (LC75710_SPI_CLOCK_DIV == 2U)
+#define LC75710_SPI_SPR         0U
+#define LC75710_SPI_2X          1U
+#elif (LC75710_SPI_CLOCK_DIV == 4U)
+#define LC75710_SPI_SPR         0U
+#define LC75710_SPI_2X          0U
+#elif (LC75710_SPI_CLOCK_DIV == 8U)
+#define LC75710_SPI_SPR         (1 << SPR0)
+#define LC75710_SPI_2X          1U
+#elif (LC75710_SPI_CLOCK_DIV == 16U)
+#define LC75710_SPI_SPR         (1 << SPR0)
+#define LC75710_SPI_2X          0U
+#else
+#error "LC75710_SPI_CLOCK_DIV must be 2, 4, 8 or 16"
+#endif
+
+/* Mode 0 (CL idles low, DI sampled on the rising edge), LSB first */
+#define LC75710_SPCR            ((1 << SPE) | (1 << DORD) | (1 << MSTR) | LC75710_SPI_SPR)
+
+#endif
+
+#ifdef DEASPLAY_BUS_STATS
+static t_lc75710_stats stats;   /**< Bus traffic, collected by the HAL */
+#endif
+
 /* PIN toggle macros */
 
 #define LC75710_CE_LOW      LC75710_PORT &= ~(1 << LC75710_CE);  /**< CE LOW */
 #define LC75710_CE_HIGH     LC75710_PORT |=  (1 << LC75710_CE);  /**< CE HIGH */
 
+#if (LC75710_SPI == 0)
+
 #define LC75710_DI_LOW      LC75710_PORT &= ~(1 << LC75710_DI);  /**< DI LOW */
 #define LC75710_DI_HIGH     LC75710_PORT |=  (1 << LC75710_DI);  /**< DI HIGH */
 
 #define LC75710_CL_LOW      LC75710_PORT &= ~(1 << LC75710_CL);  /**< CL LOW */
 #define LC75710_CL_HIGH     LC75710_PORT |=  (1 << LC75710_CL);  /**< CL HIGH */
 
-static void lc75710_write_low(uint8_t *data, uint8_t bits)
+/*
+ * One bit, unrolled: DI is written together with CL low by a single "out"
+ * (both port values are computed once per byte), then CL rises with "sbi".
+ * The "nop" keeps CL low for 3 cycles (250ns at 12MHz) against the 160ns
+ * minimum: 2 cycles only would leave no margin.
+ * About 7 cycles per bit instead of ~30 for the shift-and-test loop
+ * (estimated from the instruction sequence, not measured).
+ */
+#define LC75710_WRITE_BIT(n)    LC75710_PORT = ((data & (1U << (n))) != 0U) ? high : low; \
+                                __asm__ __volatile__ ("nop"); \
+                                LC75710_CL_HIGH
+
+static void lc75710_write_byte(uint8_t data)
+{
+    uint8_t low;
+    uint8_t high;
+
+    /* no ISR writes to LC75710_PORT: the other pins can be sampled once */
+    low = LC75710_PORT & (uint8_t)~((1 << LC75710_DI) | (1 << LC75710_CL));
+    high = low | (1 << LC75710_DI);
+
+    /* LSB first */
+    LC75710_WRITE_BIT(0);
+    LC75710_WRITE_BIT(1);
+    LC75710_WRITE_BIT(2);
+    LC75710_WRITE_BIT(3);
+    LC75710_WRITE_BIT(4);
+    LC75710_WRITE_BIT(5);
+    LC75710_WRITE_BIT(6);
+    LC75710_WRITE_BIT(7);
+
+    LC75710_CL_LOW;  /* LOW */
+}
+
+static void lc75710_write_low(uint8_t *data, uint8_t len)
 {
 
     uint8_t i;
-    uint8_t j = 0;
 
-    for (i = 0; i < bits; i++)
+#ifdef DEASPLAY_BUS_STATS
+    stats.bytes += len;
+#endif
+
+    for (i = 0; i < len; i++)
     {
-        if (j >= 8U)
-        {
-            j = 0;
-            data++;
-        }
-        if ((*data >> j) & 0x1)
+        lc75710_write_byte(*data);
+        data++;
+    }
+}
+
+#else
+
+static void lc75710_write_low(uint8_t *data, uint8_t len)
+{
+
+    uint8_t i;
+
+#ifdef DEASPLAY_BUS_STATS
+    stats.bytes += len;
+#endif
+
+    for (i = 0; i < len; i++)
+    {
+        if ((SPCR & (1 << MSTR)) == 0U)
         {
-            LC75710_DI_HIGH;
+            /* SS has been pulled low: back to master */
+            SPCR = LC75710_SPCR;
         }
         else
         {
-            LC75710_DI_LOW;
+            /* still master */
         }
 
-        j++;
+        SPDR = *data;
+        data++;
 
-        //_delay_us(1);
-        LC75710_CL_HIGH;  /* HIGH */
-        //_delay_us(1);
-        LC75710_CL_LOW;  /* LOW */
-        //_delay_us(1);
+        /* a byte takes (8 * LC75710_SPI_CLOCK_DIV) cycles: shorter than an interrupt round trip */
+        while ((SPSR & (1 << SPIF)) == 0U)
+        {
+            /* shifting */
+        }
     }
 }
 
+#endif
+
+/* Command spacing guard: TIMER2 free-running at F_CPU/8, restarted at every
+ * CE falling edge. Its overflow flag covers the (long) times in between. */
+#define LC75710_GUARD_TICKS     ((uint8_t)((F_CPU / 8UL) / (1000000UL / LC75710_COMMAND_US)) + 1U)
+
+static void lc75710_guard_start(void)
+{
+    TCNT2 = 0U;
+    TIFR = (1 << TOV2);     /* writing one clears the flag */
+}
+
+static bool lc75710_guard_elapsed(void)
+{
+    return ((TIFR & (1 << TOV2)) != 0U) || (TCNT2 >= LC75710_GUARD_TICKS);
+}
+
 static void lc75710_select(void)
 {
     uint8_t buf;
+#ifdef DEASPLAY_BUS_STATS
+    uint8_t ticks = TCNT2;
+
+    /* the loop below lasts until the end of the guard */
+    if (((TIFR & (1 << TOV2)) == 0U) && (ticks < LC75710_GUARD_TICKS))
+    {
+        stats.busy += LC75710_GUARD_TICKS - ticks;
+    }
+    stats.commands++;
+#endif
+
+    /* the previous command must have completed */
+    while (lc75710_guard_elapsed() == false)
+    {
+        /* only reached when the queue is full or disabled */
+    }
 
     /* Address goes out first... */
     LC75710_CE_LOW;
 //    _delay_us(1);
 
     buf = ADDRESS;
-    lc75710_write_low(&buf, 8);
+    lc75710_write_low(&buf, 1U);
 
     /* Then data follows after, CE goes high */
     LC75710_CE_HIGH;  /* HIGH */
@@ -126,10 +261,186 @@ static void lc75710_deselect(void)
 
     LC75710_CE_LOW;  /* LOW */
 
-    /* wait long enough for the command to complete (at least 18us for most commands) */
-    _delay_us(25);
+    /* the command executes now (at least 18us for most commands):
+     * instead of waiting here, the next select checks the guard timer */
+    lc75710_guard_start();
+
+}
+
+#if (LC75710_QUEUE_SIZE > 0U)
+
+#if (LC75710_QUEUE_SIZE < (LC75710_DIGITS + 4U))
+#error "LC75710_QUEUE_SIZE must hold a full line write"
+#endif
+
+/*
+ * Command queue: frames of [length][length bytes], sent LSB first
+ * between one select / deselect pair. Filled by the command functions,
+ * drained by lc75710_poll() without ever waiting for the chip.
+ */
+static uint8_t queue[LC75710_QUEUE_SIZE];   /**< Ring buffer */
+static uint8_t queue_head = 0U;             /**< Next byte to send */
+static uint8_t queue_tail = 0U;             /**< Next free byte */
+static uint8_t queue_used = 0U;             /**< Bytes in the ring */
+static bool    queue_direct = false;        /**< The frame in progress bypasses the ring */
+
+static void lc75710_queue_push(uint8_t data)
+{
+    queue[queue_tail] = data;
+    queue_tail++;
+    if (queue_tail >= LC75710_QUEUE_SIZE) queue_tail = 0U;
+    queue_used++;
+}
+
+static uint8_t lc75710_queue_pop(void)
+{
+    uint8_t data = queue[queue_head];
+    queue_head++;
+    if (queue_head >= LC75710_QUEUE_SIZE) queue_head = 0U;
+    queue_used--;
+    return data;
+}
+
+static void lc75710_queue_send(void)
+{
+    uint8_t len;
+    uint8_t data;
+
+    len = lc75710_queue_pop();
+
+    lc75710_select();
+    while (len > 0U)
+    {
+        data = lc75710_queue_pop();
+        lc75710_write_low(&data, 1U);
+        len--;
+    }
+    lc75710_deselect();
+}
+
+static void lc75710_frame_begin(uint8_t len)
+{
+    if ((len + 1U) > LC75710_QUEUE_SIZE)
+    {
+        /* larger than the whole ring (e.g. a long burst): send everything
+         * queued before it, then this one right away */
+        while (queue_used != 0U)
+        {
+            lc75710_queue_send();
+        }
+        lc75710_select();
+        queue_direct = true;
+    }
+    else
+    {
+        while ((queue_used != 0U) && ((LC75710_QUEUE_SIZE - queue_used) < (len + 1U)))
+        {
+            /* full: make room, waiting for the chip if needed */
+            lc75710_queue_send();
+        }
+        lc75710_queue_push(len);
+    }
+}
+
+static void lc75710_frame_data(uint8_t *data, uint8_t len)
+{
+    if (queue_direct == true)
+    {
+        lc75710_write_low(data, len);
+    }
+    else
+    {
+        while (len > 0U)
+        {
+            lc75710_queue_push(*data);
+            data++;
+            len--;
+        }
+    }
+}
+
+static void lc75710_frame_end(void)
+{
+    if (queue_direct == true)
+    {
+        lc75710_deselect();
+        queue_direct = false;
+    }
+    else
+    {
+        /* sent by lc75710_poll() */
+    }
+}
+
+#else
+
+static void lc75710_frame_begin(uint8_t len)
+{
+    (void)len;
+    lc75710_select();
+}
+
+static void lc75710_frame_data(uint8_t *data, uint8_t len)
+{
+    lc75710_write_low(data, len);
+}
+
+static void lc75710_frame_end(void)
+{
+    lc75710_deselect();
+}
+
+#endif
+
+/**
+ * @brief
+ *   Send the queued commands whose turn has come. Never waits: one
+ *   command goes out per call, only when the previous one has completed.
+ *   Call it periodically (the deasplay HAL does it in display_periodic()).
+ */
+void lc75710_poll(void)
+{
+#if (LC75710_QUEUE_SIZE > 0U)
+    if ((queue_used != 0U) && (lc75710_guard_elapsed() == true))
+    {
+        lc75710_queue_send();
+    }
+    else
+    {
+        /* empty, or the chip is busy */
+    }
+#endif
+}
+
+/**
+ * @brief
+ *   Tell whether all the commands have been sent to the chip.
+ *
+ * @return true when the command queue is empty
+ */
+bool lc75710_idle(void)
+{
+#if (LC75710_QUEUE_SIZE > 0U)
+    return (queue_used == 0U);
+#else
+    return true;
+#endif
+}
 
+#ifdef DEASPLAY_BUS_STATS
+/**
+ * @brief
+ *   Get the bus traffic counters: the commands and the bytes actually
+ *   sent, so the queued ones are counted once they leave the queue.
+ *   They wrap around: the caller takes them and clears them often.
+ *
+ * @return the counters
+ */
+t_lc75710_stats* lc75710_stats(void)
+{
+    return &stats;
 }
+#endif
 
 /**
  * @brief
@@ -145,11 +456,11 @@ static void lc75710_deselect(void)
 void lc75710_write(uint32_t data)
 {
 
-    lc75710_select();
+    lc75710_frame_begin(3U);
 
-    lc75710_write_low((uint8_t*)&data, 24);
+    lc75710_frame_data((uint8_t*)&data, 3U);
 
-    lc75710_deselect();
+    lc75710_frame_end();
 
 }
 
@@ -335,6 +646,51 @@ void lc75710_dcram_write(uint8_t addr, uint8_t data)
 
 }
 
+/**
+ * @brief
+ *   Write consecutive DCRAM locations with a single command.
+ *   The first character goes with the DCRAM write command, the following
+ *   ones are clocked in as plain 8-bit data within the same CE window:
+ *   the chip address counter auto-increments after every character.
+ *   Compared to one command per character, this saves 24 bits and the
+ *   command completion wait for every additional character.
+ *
+ * @param addr 6-bit DCRAM address of the first character
+ * @param data the characters (CGROM or CGRAM codes)
+ * @param len  the number of characters, 1..LC75710_DRAM_SIZE (bursts larger
+ *             than the command queue are sent right away, waiting for the chip)
+ */
+void lc75710_dcram_write_burst(uint8_t addr, uint8_t *data, uint8_t len)
+{
+
+    uint32_t temp = 0;
+    if (len > 0U)
+    {
+        /* Instruction */
+        temp  = (uint32_t)0x6 << 20;
+
+        /* DCRAM address */
+        temp |= (uint32_t)(addr & 0x3F) << 8;
+
+        /* First character */
+        temp |= (uint32_t)data[0];
+
+        /* Write to IC: the following characters go to auto-incremented addresses */
+        lc75710_frame_begin(3U + len - 1U);
+
+        lc75710_frame_data((uint8_t*)&temp, 3U);
+
+        lc75710_frame_data(&data[1], len - 1U);
+
+        lc75710_frame_end();
+    }
+    else
+    {
+        /* nothing to write */
+    }
+
+}
+
 /**
  * @brief
  *   Send a ADRAM write command to the chip.
@@ -364,30 +720,53 @@ void lc75710_adram_write(uint8_t addr, uint8_t data)
 /**
  * @brief
  *   Send a CGRAM write command to the chip.
- * 
+ *   The 35 dots are packed in 5 bytes, dot (row, column) being bit
+ *   row * 5 + column, followed by the address and the instruction.
+ *
  * @param addr 8-bit CGRAM address
- * @param data the 35-bit data (arbitrary dots, forming a 7x5 character)
+ * @param rows the LC75710_CGRAM_ROWS rows of the 7x5 character, top first,
+ *             5 columns each (bit 0 on the left)
  */
-void lc75710_cgram_write(uint8_t addr, uint64_t data)
+void lc75710_cgram_write(uint8_t addr, const uint8_t *rows)
 {
 
-    uint64_t temp = 0;
+    uint8_t frame[7];
+    uint16_t dots = 0;      /* dots not in the frame yet */
+    uint8_t bits = 0;
+    uint8_t len = 0;
+    uint8_t i = 0;
 
-    /* Instruction */
-    temp  = (uint64_t)0x8 << 52;
+    /* Dots: 5 bits per row, 8 bits per byte */
+    for (i = 0; i < LC75710_CGRAM_ROWS; i++)
+    {
+        dots |= (uint16_t)(rows[i] & 0x1FU) << bits;
+        bits += 5U;
+        if (bits >= 8U)
+        {
+            frame[len] = (uint8_t)dots;
+            len++;
+            dots >>= 8;
+            bits -= 8U;
+        }
+    }
+    frame[len] = (uint8_t)dots;     /* the last 3 dots */
 
     /* CGRAM address */
-    temp |= (uint64_t)(addr & 0xFF) << 40;
+    frame[5] = addr;
 
-    /* ADRAM address */
-    temp |= data;
+    /* Instruction */
+    frame[6] = 0x8U << 4;
 
     /* Write to IC */
-    lc75710_select();
+    lc75710_frame_begin(7U);
 
-    lc75710_write_low((uint8_t*)&temp, 56);
+    lc75710_frame_data(frame, 7U);
 
-    lc75710_deselect();
+    lc75710_frame_end();
+
+#ifdef DEASPLAY_BUS_STATS
+    stats.cgram++;
+#endif
 
 }
 
@@ -401,15 +780,29 @@ void lc75710_init()
     uint8_t i = 0;
 
     /* Pin configuration */
+#if (LC75710_SPI == 0)
     LC75710_DDR |= 1 << LC75710_CL;  /* OUTPUT */
     LC75710_DDR |= 1 << LC75710_DI;  /* OUTPUT */
+#else
+    LC75710_SPI_DDR |= 1 << LC75710_SPI_SCK;   /* OUTPUT */
+    LC75710_SPI_DDR |= 1 << LC75710_SPI_MOSI;  /* OUTPUT */
+#endif
     LC75710_DDR |= 1 << LC75710_CE;  /* OUTPUT */
 
     /* Initial output states */
+#if (LC75710_SPI == 0)
     LC75710_CL_LOW;
     LC75710_DI_LOW;
+#else
+    SPCR = LC75710_SPCR;
+    SPSR = (LC75710_SPI_2X << SPI2X);
+#endif
     LC75710_CE_LOW;
 
+    /* Command spacing guard timer (TIMER2, F_CPU/8) */
+    TCCR2 = (1 << CS21);
+    lc75710_guard_start();
+
     /* After powerup the display shall be initialized,
      * otherwise registers contain garbage data
      */
@@ -35,6 +35,28 @@
 #define ADDRESS             103U   /**< Chip address (B11100110) */
 #define LC75710_DIGITS      10U    /**< Number of digits for a given implementation */
 #define LC75710_DRAM_SIZE   64U    /**< Size of the internal DCRAM */
+#define LC75710_CGRAM_SIZE  16U    /**< Number of user defined characters (CGRAM) */
+#define LC75710_CGRAM_ROWS  7U     /**< Rows of a user defined character (5 dots each) */
+#define LC75710_COMMAND_US  25U    /**< Command execution time (18us for most commands) */
+
+#ifndef LC75710_SPI
+#define LC75710_SPI         0U     /**< 1: DI / CL on the hardware SPI (MOSI / SCK), see lc75710.c. Not tested on hardware yet */
+#endif
+
+#ifndef LC75710_QUEUE_SIZE
+#define LC75710_QUEUE_SIZE  32U    /**< Command queue (bytes), see lc75710_poll(). 0: send right away */
+#endif
+
+/**< Bus traffic counters (DEASPLAY_BUS_STATS), see lc75710_stats() */
+typedef struct
+{
+    uint16_t commands;      /**< Commands sent (CE windows) */
+    uint16_t bytes;         /**< Bytes clocked out, chip addresses included */
+    uint16_t busy;          /**< Waits for the previous command [TIMER2 ticks] */
+    uint8_t  cgram;         /**< CGRAM writes */
+} t_lc75710_stats;
+
+#define LC75710_TICKS_US(ticks) (((uint32_t)(ticks) * 8UL) / (F_CPU / 1000000UL))  /**< TIMER2 (F_CPU/8) ticks to us */
 
 /* Modes of operation */
 #define NO_MDATA_NOR_ADATA      0x0     /**< Command does not affect MDATA nor ADATA */
@@ -43,7 +65,6 @@
 #define MDATA_AND_ADATA         0x3     /**< Command does affect both ADATA and MDATA */
 
 void lc75710_write(uint32_t data);
-void lc75710_write_56bits(uint64_t data);
 void lc75710_blink(uint8_t operation, uint8_t period, uint16_t digits);
 void lc75710_on_off(uint8_t operation, bool mode, uint16_t grids);
 void lc75710_shift(uint8_t operation, bool direction);
@@ -51,9 +72,15 @@ void lc75710_grid_register_load(uint8_t grids);
 void lc75710_set_ac_address(uint8_t dcram, uint8_t adram);
 void lc75710_intensity(uint8_t intensity);
 void lc75710_dcram_write(uint8_t addr, uint8_t data);
+void lc75710_dcram_write_burst(uint8_t addr, uint8_t *data, uint8_t len);
 void lc75710_adram_write(uint8_t addr, uint8_t data);
-void lc75710_cgram_write(uint8_t addr, uint64_t data);
+void lc75710_cgram_write(uint8_t addr, const uint8_t *rows);
 void lc75710_init(void);
+void lc75710_poll(void);
+bool lc75710_idle(void);
+#ifdef DEASPLAY_BUS_STATS
+t_lc75710_stats* lc75710_stats(void);
+#endif
 
 #endif
 
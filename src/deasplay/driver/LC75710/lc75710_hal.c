@@ -28,11 +28,15 @@
 
 #include <stdbool.h>
 #include <stdint.h>
+#include <string.h>
 
 #include "lc75710.h"
 #include "lc75710_hal.h"
 
+#define LC75710_HAL_ADDRESS(chr)    ((uint8_t)(origin + LC75710_DIGITS - 1U - (chr)) & (LC75710_DRAM_SIZE - 1U))
+
 static uint8_t pos = 0;
+static uint8_t origin = 0;      /**< DCRAM address of the rightmost digit, moved by the display shifts */
 
 void lc75710_display_hal_init(void)
 {
@@ -57,7 +61,7 @@ void lc75710_display_hal_power(e_deasplay_power state)
 
 void lc75710_display_hal_set_cursor(uint8_t line, uint8_t chr)
 {
-    pos = LC75710_DIGITS - 1 - chr;
+    pos = LC75710_HAL_ADDRESS(chr);
 }
 
 void lc75710_display_hal_write_char(uint8_t chr)
@@ -65,6 +69,92 @@ void lc75710_display_hal_write_char(uint8_t chr)
     lc75710_dcram_write(pos, chr);
 }
 
+void lc75710_display_hal_write_run(uint8_t line, uint8_t chr, uint8_t *data, uint8_t len)
+{
+    uint8_t buf[LC75710_CHARS];
+    uint8_t addr;
+    uint8_t i;
+
+    /* DCRAM addresses run the other way: send the run reversed,
+     * starting from the address of its last character */
+    for (i = 0; i < len; i++)
+    {
+        buf[i] = data[len - 1U - i];
+    }
+
+    /* the DCRAM is a ring: split the run where the addresses wrap */
+    addr = LC75710_HAL_ADDRESS(chr + len - 1U);
+    if ((addr + len) > LC75710_DRAM_SIZE)
+    {
+        i = LC75710_DRAM_SIZE - addr;
+        lc75710_dcram_write_burst(addr, buf, i);
+        lc75710_dcram_write_burst(0U, &buf[i], len - i);
+    }
+    else
+    {
+        lc75710_dcram_write_burst(addr, buf, len);
+    }
+}
+
+void lc75710_display_hal_shift(void)
+{
+    /* every digit shows the DCRAM address of its right neighbour:
+     * the rightmost one gets the address before the old origin */
+    lc75710_shift(MDATA_ONLY, true);
+    origin = (origin - 1U) & (LC75710_DRAM_SIZE - 1U);
+}
+
+void lc75710_display_hal_blink(uint8_t line, uint32_t mask, uint16_t period)
+{
+    uint16_t digits = 0U;
+    uint8_t code = 0U;
+    uint8_t chr;
+
+    (void)line;
+
+    /* grids are counted from the right: mirror the mask */
+    for (chr = 0U; chr < LC75710_DIGITS; chr++)
+    {
+        if (((mask >> chr) & 0x1U) != 0U) digits |= (1U << (LC75710_DIGITS - 1U - chr));
+    }
+
+    /* the 8 period codes span 0.1 to 1.0 seconds */
+    if (period > LC75710_BLINK_MIN_MS)
+    {
+        code = (uint8_t)((((uint32_t)(period - LC75710_BLINK_MIN_MS) * 7U) + ((LC75710_BLINK_MAX_MS - LC75710_BLINK_MIN_MS) / 2U)) /
+                         (LC75710_BLINK_MAX_MS - LC75710_BLINK_MIN_MS));
+        if (code > 7U) code = 7U;
+    }
+
+    lc75710_blink(MDATA_AND_ADATA, code, digits);
+}
+
+void lc75710_display_hal_glyph_define(uint8_t slot, const uint8_t *rows)
+{
+    /* same row layout as the deasplay glyphs */
+    lc75710_cgram_write(slot, rows);
+}
+
+void lc75710_display_hal_poll(void)
+{
+    /* hand the queued commands to the chip, as fast as it accepts them */
+    lc75710_poll();
+}
+
+#ifdef DEASPLAY_BUS_STATS
+void lc75710_display_hal_bus(t_display_bus_count *count)
+{
+    t_lc75710_stats *stats = lc75710_stats();
+
+    /* hand over what went out since the last call */
+    count->transactions += stats->commands;
+    count->bits += (uint32_t)stats->bytes * 8U;
+    count->busy += LC75710_TICKS_US(stats->busy);
+    count->cgram += stats->cgram;
+    memset(stats, 0, sizeof(t_lc75710_stats));
+}
+#endif
+
 void lc75710_display_hal_cursor_visibility(bool visible)
 {
     /* Not available on the LC75710 controller */
@@ -33,11 +33,21 @@
 
 #define LC75710_LINES        1U     /**< Number of lines */
 #define LC75710_CHARS       10U     /**< Number of character per lines */
+#define LC75710_BLINK_MIN_MS   100U     /**< Blink period of the code 0 */
+#define LC75710_BLINK_MAX_MS  1000U     /**< Blink period of the code 7 */
 
 void lc75710_display_hal_init(void);
 void lc75710_display_hal_power(e_deasplay_power state);
 void lc75710_display_hal_set_cursor(uint8_t line, uint8_t chr);
 void lc75710_display_hal_write_char(uint8_t chr);
+void lc75710_display_hal_write_run(uint8_t line, uint8_t chr, uint8_t *data, uint8_t len);
+void lc75710_display_hal_shift(void);
+void lc75710_display_hal_blink(uint8_t line, uint32_t mask, uint16_t period);
+void lc75710_display_hal_glyph_define(uint8_t slot, const uint8_t *rows);
+void lc75710_display_hal_poll(void);
 void lc75710_display_hal_cursor_visibility(bool visible);
+#ifdef DEASPLAY_BUS_STATS
+void lc75710_display_hal_bus(t_display_bus_count *count);
+#endif
 
 #endif /* SRC_DEASPLAY_DRIVER_LC75710_LC75710_HAL_H_ */
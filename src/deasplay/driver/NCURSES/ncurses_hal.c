@@ -0,0 +1,309 @@
+/*
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+    Lorenzo Miori (C) 2016 [ 3M4|L: memoryS60<at>gmail.com ]
+
+    Version History
+        * 1.0 initial
+
+*/
+
+/**
+ * @file ncurses_hal.c
+ * @author Lorenzo Miori
+ * @date Oct 2016
+ * @brief Display HAL to interface the APIs to a terminal (see ncurses_hal.h)
+ */
+
+#include "../../deasplay.h"
+#include "../../configuration.h"
+
+#ifdef DEASPLAY_NCURSES
+
+#include <stdlib.h>
+#include <time.h>
+#include <ncurses.h>
+
+#define NCURSES_HAL_ROW_DISPLAY     1       /**< Top border of the display */
+#define NCURSES_HAL_ROW_STATUS      (NCURSES_HAL_ROW_DISPLAY + NCURSES_DISPLAY_LINES + 3)
+#define NCURSES_HAL_GLYPH_DOTS      (DEASPLAY_GLYPH_ROWS * 5U)
+
+static uint8_t cells[NCURSES_DISPLAY_LINES][NCURSES_DISPLAY_CHARS];     /**< What the display shows */
+static uint8_t glyphs[NCURSES_DISPLAY_GLYPHS];  /**< Lit dots of each glyph (0: not defined) */
+static uint32_t glyphs_defined = 0U;            /**< A bit per character code with a glyph */
+static uint8_t cursor_line = 0U;
+static uint8_t cursor_chr = 0U;
+static bool powered = false;
+static bool redraw = false;                     /**< Changes outside a refresh */
+static bool active = false;                     /**< Terminal in curses mode */
+static struct timespec frame_start;
+static t_ncurses_display_stats stats;
+
+static uint64_t ncurses_hal_now_ns(void)
+{
+    struct timespec now;
+
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return ((uint64_t)now.tv_sec * 1000000000ULL) + (uint64_t)now.tv_nsec;
+}
+
+static chtype ncurses_hal_cell(uint8_t code)
+{
+    uint8_t dots;
+    chtype c;
+
+    if ((code < NCURSES_DISPLAY_GLYPHS) && (((glyphs_defined >> code) & 0x1U) != 0U))
+    {
+        /* a darker shade for every third of the dots lit */
+        dots = glyphs[code];
+        if (dots == 0U) c = ' ';
+        else if (dots < (NCURSES_HAL_GLYPH_DOTS / 3U)) c = ACS_BOARD;
+        else if (dots < ((2U * NCURSES_HAL_GLYPH_DOTS) / 3U)) c = ACS_CKBOARD;
+        else c = ACS_BLOCK;
+    }
+    else if ((code >= 0x20U) && (code < 0x7FU))
+    {
+        c = code;
+    }
+    else
+    {
+        /* not printable */
+        c = '?';
+    }
+
+    return c;
+}
+
+static void ncurses_hal_draw(void)
+{
+    uint8_t line;
+    uint8_t chr;
+
+    mvhline(NCURSES_HAL_ROW_DISPLAY, 1, ACS_HLINE, NCURSES_DISPLAY_CHARS);
+    mvhline(NCURSES_HAL_ROW_DISPLAY + NCURSES_DISPLAY_LINES + 1, 1, ACS_HLINE, NCURSES_DISPLAY_CHARS);
+    mvaddch(NCURSES_HAL_ROW_DISPLAY, 0, ACS_ULCORNER);
+    mvaddch(NCURSES_HAL_ROW_DISPLAY, NCURSES_DISPLAY_CHARS + 1, ACS_URCORNER);
+    mvaddch(NCURSES_HAL_ROW_DISPLAY + NCURSES_DISPLAY_LINES + 1, 0, ACS_LLCORNER);
+    mvaddch(NCURSES_HAL_ROW_DISPLAY + NCURSES_DISPLAY_LINES + 1, NCURSES_DISPLAY_CHARS + 1, ACS_LRCORNER);
+
+    for (line = 0U; line < NCURSES_DISPLAY_LINES; line++)
+    {
+        mvaddch(NCURSES_HAL_ROW_DISPLAY + 1 + line, 0, ACS_VLINE);
+        for (chr = 0U; chr < NCURSES_DISPLAY_CHARS; chr++)
+        {
+            addch((powered == true) ? ncurses_hal_cell(cells[line][chr]) : ' ');
+        }
+        addch(ACS_VLINE);
+    }
+
+    refresh();
+    redraw = false;
+}
+
+static void ncurses_hal_write(uint8_t line, uint8_t chr, uint8_t data)
+{
+    if ((line < NCURSES_DISPLAY_LINES) && (chr < NCURSES_DISPLAY_CHARS))
+    {
+        cells[line][chr] = data;
+    }
+    else
+    {
+        /* off screen, as the real controllers do */
+    }
+}
+
+void ncurses_display_hal_init(void)
+{
+    uint8_t line;
+    uint8_t chr;
+
+    for (line = 0U; line < NCURSES_DISPLAY_LINES; line++)
+    {
+        for (chr = 0U; chr < NCURSES_DISPLAY_CHARS; chr++)
+        {
+            cells[line][chr] = (uint8_t)' ';
+        }
+    }
+
+    if (active == false)
+    {
+        initscr();
+        cbreak();
+        noecho();
+        nodelay(stdscr, TRUE);
+        keypad(stdscr, TRUE);
+        curs_set(0);
+        active = true;
+        /* leave the terminal usable whatever the way out */
+        atexit(ncurses_display_hal_exit);
+    }
+
+    ncurses_hal_draw();
+}
+
+void ncurses_display_hal_power(e_deasplay_power state)
+{
+    powered = (state == DEASPLAY_POWER_ON);
+    redraw = true;
+}
+
+void ncurses_display_hal_set_cursor(uint8_t line, uint8_t chr)
+{
+    cursor_line = line;
+    cursor_chr = chr;
+}
+
+void ncurses_display_hal_write_char(uint8_t chr)
+{
+    ncurses_hal_write(cursor_line, cursor_chr, chr);
+    cursor_chr++;
+    stats.runs++;
+    stats.chars++;
+}
+
+void ncurses_display_hal_write_run(uint8_t line, uint8_t chr, uint8_t *data, uint8_t len)
+{
+    uint8_t i;
+
+    for (i = 0U; i < len; i++)
+    {
+        ncurses_hal_write(line, chr + i, data[i]);
+    }
+    stats.runs++;
+    stats.chars += len;
+}
+
+void ncurses_display_hal_glyph_define(uint8_t slot, const uint8_t *rows)
+{
+    uint8_t dots = 0U;
+    uint8_t row;
+    uint8_t bits;
+
+    if (slot < NCURSES_DISPLAY_GLYPHS)
+    {
+        for (row = 0U; row < DEASPLAY_GLYPH_ROWS; row++)
+        {
+            for (bits = rows[row] & 0x1FU; bits != 0U; bits &= (uint8_t)(bits - 1U))
+            {
+                dots++;
+            }
+        }
+        glyphs[slot] = dots;
+        glyphs_defined |= (1UL << slot);
+        redraw = true;
+    }
+    stats.glyphs++;
+}
+
+void ncurses_display_hal_frame_begin(void)
+{
+    stats.frames++;
+    clock_gettime(CLOCK_MONOTONIC, &frame_start);
+}
+
+void ncurses_display_hal_frame_end(void)
+{
+    uint64_t time = ncurses_hal_now_ns() -
+                    (((uint64_t)frame_start.tv_sec * 1000000000ULL) + (uint64_t)frame_start.tv_nsec);
+
+    stats.dirty++;
+    stats.time_ns += time;
+    if (time > stats.time_max_ns) stats.time_max_ns = time;
+
+    /* drawing is not part of the figures */
+    ncurses_hal_draw();
+}
+
+void ncurses_display_hal_poll(void)
+{
+    if (active == true)
+    {
+        if (redraw == true)
+        {
+            ncurses_hal_draw();
+        }
+        ncurses_display_hal_input(getch());
+    }
+}
+
+void ncurses_display_hal_cursor_visibility(bool visible)
+{
+    /* the cell is drawn as is: nothing to show */
+    (void)visible;
+}
+
+/**
+ * ncurses_display_hal_status
+ *
+ * @brief Show a line of text under the display
+ * @param status    the text, replaces the previous one
+ */
+void ncurses_display_hal_status(const char *status)
+{
+    if (active == true)
+    {
+        mvaddstr(NCURSES_HAL_ROW_STATUS, 0, status);
+        clrtoeol();
+        redraw = true;
+    }
+}
+
+/**
+ * ncurses_display_hal_exit
+ *
+ * @brief Give the terminal back (registered at exit by the init)
+ */
+void ncurses_display_hal_exit(void)
+{
+    if (active == true)
+    {
+        endwin();
+        active = false;
+    }
+}
+
+/**
+ * ncurses_display_hal_stats
+ *
+ * @brief Get the flush profiling counters (they can be reset through the pointer)
+ * @return the counters
+ */
+t_ncurses_display_stats* ncurses_display_hal_stats(void)
+{
+    return &stats;
+}
+
+/**
+ * ncurses_display_hal_report
+ *
+ * @brief Print the flush profiling summary
+ * @param out   where to print it
+ */
+void ncurses_display_hal_report(FILE *out)
+{
+    uint32_t dirty = (stats.dirty == 0U) ? 1U : stats.dirty;
+
+    fprintf(out, "display_periodic() calls  %lu\n", (unsigned long)stats.frames);
+    fprintf(out, "  clean                   %lu\n", (unsigned long)(stats.frames - stats.dirty));
+    fprintf(out, "  dirty                   %lu\n", (unsigned long)stats.dirty);
+    fprintf(out, "writes per dirty call     %.2f (%.2f chars)\n",
+            (double)stats.runs / dirty, (double)stats.chars / dirty);
+    fprintf(out, "chars per write           %.2f\n",
+            (double)stats.chars / ((stats.runs == 0U) ? 1U : stats.runs));
+    fprintf(out, "glyphs defined            %lu\n", (unsigned long)stats.glyphs);
+    fprintf(out, "dirty call time           %.0f ns average, %llu ns max\n",
+            (double)stats.time_ns / dirty, (unsigned long long)stats.time_max_ns);
+}
+
+#endif
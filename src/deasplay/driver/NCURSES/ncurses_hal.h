@@ -0,0 +1,83 @@
+/*
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+    Lorenzo Miori (C) 2016 [ 3M4|L: memoryS60<at>gmail.com ]
+
+    Version History
+        * 1.0 initial
+
+*/
+
+/**
+ * @file ncurses_hal.h
+ * @author Lorenzo Miori
+ * @date Oct 2016
+ * @brief Display HAL drawing the display in a terminal (host builds only)
+ *
+ * The characters sent by display_periodic() land in a shadow of the
+ * display; the terminal is redrawn once per refresh, after the flush
+ * has been timed, so the figures only account for the deasplay code.
+ * Custom glyphs are drawn with a shade matching their lit dots.
+ */
+
+#ifndef SRC_DEASPLAY_DRIVER_NCURSES_NCURSES_HAL_H_
+#define SRC_DEASPLAY_DRIVER_NCURSES_NCURSES_HAL_H_
+
+#include <stdio.h>
+
+#include "../../deasplay.h"
+
+#ifndef NCURSES_DISPLAY_LINES
+#define NCURSES_DISPLAY_LINES    1U     /**< Number of lines */
+#endif
+#ifndef NCURSES_DISPLAY_CHARS
+#define NCURSES_DISPLAY_CHARS   10U     /**< Number of character per lines */
+#endif
+#ifndef NCURSES_DISPLAY_GLYPHS
+#define NCURSES_DISPLAY_GLYPHS  16U     /**< Custom characters, up to 32 (as the LC75710 by default) */
+#endif
+
+/**< Flush profiling counters */
+typedef struct
+{
+    uint32_t frames;        /**< display_periodic() calls */
+    uint32_t dirty;         /**< Calls that have sent something */
+    uint32_t runs;          /**< Write commands (runs or single characters) */
+    uint32_t chars;         /**< Characters sent */
+    uint32_t glyphs;        /**< Custom glyphs defined */
+    uint64_t time_ns;       /**< Time spent in the dirty refreshes */
+    uint64_t time_max_ns;   /**< Longest dirty refresh */
+} t_ncurses_display_stats;
+
+void ncurses_display_hal_init(void);
+void ncurses_display_hal_power(e_deasplay_power state);
+void ncurses_display_hal_set_cursor(uint8_t line, uint8_t chr);
+void ncurses_display_hal_write_char(uint8_t chr);
+void ncurses_display_hal_write_run(uint8_t line, uint8_t chr, uint8_t *data, uint8_t len);
+void ncurses_display_hal_glyph_define(uint8_t slot, const uint8_t *rows);
+void ncurses_display_hal_frame_begin(void);
+void ncurses_display_hal_frame_end(void);
+void ncurses_display_hal_poll(void);
+void ncurses_display_hal_cursor_visibility(bool visible);
+
+void ncurses_display_hal_status(const char *status);
+void ncurses_display_hal_exit(void);
+t_ncurses_display_stats* ncurses_display_hal_stats(void);
+void ncurses_display_hal_report(FILE *out);
+
+/** Provided by the application: called at every poll with the
+ *  key pressed in the terminal (ERR when none) */
+void ncurses_display_hal_input(int key);
+
+#endif /* SRC_DEASPLAY_DRIVER_NCURSES_NCURSES_HAL_H_ */
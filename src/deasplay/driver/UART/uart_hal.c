@@ -0,0 +1,153 @@
+/*
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+    Lorenzo Miori (C) 2016 [ 3M4|L: memoryS60<at>gmail.com ]
+
+    Version History
+        * 1.0 initial
+
+*/
+
+/**
+ * @file uart_hal.c
+ * @author Lorenzo Miori
+ * @date Oct 2016
+ * @brief Display HAL to interface the APIs to the UART (see uart_hal.h)
+ */
+
+#include "../../deasplay.h"
+#include "../../configuration.h"
+
+#ifdef DEASPLAY_UART
+
+#include <avr/io.h>
+#include <avr/interrupt.h>
+
+#if ((DEASPLAY_UART_TX_SIZE & (DEASPLAY_UART_TX_SIZE - 1U)) != 0U)
+#error "DEASPLAY_UART_TX_SIZE must be a power of two"
+#endif
+
+/* Double speed: 38400 baud is 0.2% off at 12MHz (2.3% at normal speed) */
+#define UART_HAL_UBRR   (((F_CPU + (4UL * DEASPLAY_UART_BAUD)) / (8UL * DEASPLAY_UART_BAUD)) - 1UL)
+
+static uint8_t tx_buffer[DEASPLAY_UART_TX_SIZE];    /**< Bytes waiting for the transmitter */
+static volatile uint8_t tx_head = 0U;               /**< Next free byte (main loop) */
+static volatile uint8_t tx_tail = 0U;               /**< Next byte to send (ISR) */
+static uint8_t pos = 0U;                            /**< Cursor, as the position byte */
+static uint8_t sequence = 0U;                       /**< Refresh counter */
+
+/**
+ * ISR(USART_UDRE_vect)
+ *
+ * @brief Feed the transmitter, one byte per interrupt
+ */
+ISR(USART_UDRE_vect)
+{
+    if (tx_tail == tx_head)
+    {
+        /* nothing left */
+        UCSRB &= ~(1 << UDRIE);
+    }
+    else
+    {
+        UDR = tx_buffer[tx_tail];
+        tx_tail = (tx_tail + 1U) & (DEASPLAY_UART_TX_SIZE - 1U);
+    }
+}
+
+static void uart_hal_tx(uint8_t data)
+{
+    uint8_t next = (tx_head + 1U) & (DEASPLAY_UART_TX_SIZE - 1U);
+
+    while (next == tx_tail)
+    {
+        /* full: wait for the ISR, or do its job while the interrupts are off (init) */
+        if (((SREG & (1 << SREG_I)) == 0U) && ((UCSRA & (1 << UDRE)) != 0U))
+        {
+            UDR = tx_buffer[tx_tail];
+            tx_tail = (tx_tail + 1U) & (DEASPLAY_UART_TX_SIZE - 1U);
+        }
+    }
+
+    tx_buffer[tx_head] = data;
+    tx_head = next;
+    UCSRB |= (1 << UDRIE);
+}
+
+void uart_display_hal_init(void)
+{
+    UBRRH = (uint8_t)(UART_HAL_UBRR >> 8);
+    UBRRL = (uint8_t)UART_HAL_UBRR;
+    UCSRA = (1 << U2X);
+    UCSRC = (1 << URSEL) | (1 << UCSZ1) | (1 << UCSZ0);     /* 8N1 */
+    UCSRB = (1 << TXEN);
+
+    uart_hal_tx(UART_DISPLAY_HELLO);
+    uart_hal_tx(UART_DISPLAY_LINES);
+    uart_hal_tx(UART_DISPLAY_CHARS);
+}
+
+void uart_display_hal_power(e_deasplay_power state)
+{
+    uart_hal_tx(UART_DISPLAY_POWER | ((state == DEASPLAY_POWER_ON) ? 1U : 0U));
+}
+
+void uart_display_hal_set_cursor(uint8_t line, uint8_t chr)
+{
+    pos = (uint8_t)(line << 5) | chr;
+}
+
+void uart_display_hal_write_char(uint8_t chr)
+{
+    uart_hal_tx(UART_DISPLAY_RUN);
+    uart_hal_tx(pos);
+    uart_hal_tx(chr);
+    pos++;
+}
+
+void uart_display_hal_write_run(uint8_t line, uint8_t chr, uint8_t *data, uint8_t len)
+{
+    uint8_t i;
+
+    uart_hal_tx(UART_DISPLAY_RUN | (len - 1U));
+    uart_hal_tx((uint8_t)(line << 5) | chr);
+    for (i = 0; i < len; i++)
+    {
+        uart_hal_tx(data[i]);
+    }
+}
+
+void uart_display_hal_glyph_define(uint8_t slot, const uint8_t *rows)
+{
+    uint8_t i;
+
+    uart_hal_tx(UART_DISPLAY_GLYPH | (slot & 0x1FU));
+    for (i = 0; i < DEASPLAY_GLYPH_ROWS; i++)
+    {
+        uart_hal_tx(rows[i]);
+    }
+}
+
+void uart_display_hal_frame_end(void)
+{
+    uart_hal_tx(UART_DISPLAY_FRAME | (sequence & 0x1FU));
+    sequence++;
+}
+
+void uart_display_hal_cursor_visibility(bool visible)
+{
+    uart_hal_tx(UART_DISPLAY_CURSOR | ((visible == true) ? 1U : 0U));
+}
+
+#endif
@@ -0,0 +1,83 @@
+/*
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+    Lorenzo Miori (C) 2016 [ 3M4|L: memoryS60<at>gmail.com ]
+
+    Version History
+        * 1.0 initial
+
+*/
+
+/**
+ * @file uart_hal.h
+ * @author Lorenzo Miori
+ * @date Oct 2016
+ * @brief Display HAL mirroring the display over the UART
+ *
+ * Binary protocol, one command byte (opcode in the 3 upper bits)
+ * optionally followed by its data:
+ *
+ *   001nnnnn  line/chr  n+1 chars    characters at (line, chr), left to right
+ *   010sssss  7 rows                 custom glyph for the character code s
+ *   011qqqqq                         end of a refresh, q: sequence number (mod 32)
+ *   100xxxxp                         power, p: 1 on
+ *   101xxxxv                         cursor, v: 1 visible
+ *   110xxxxx  lines chars            hello: display geometry, everything cleared
+ *
+ * The position byte is (line << 5) | chr. Glyph rows go top first,
+ * 5 columns each with bit 0 on the left. Other opcodes are invalid:
+ * a decoder skips them. A full 10 characters refresh is 13 bytes,
+ * i.e. 60 frames per second take 20% of a 38400 baud line.
+ * See tools/deasplay_uart.py for a terminal decoder.
+ */
+
+#ifndef SRC_DEASPLAY_DRIVER_UART_UART_HAL_H_
+#define SRC_DEASPLAY_DRIVER_UART_UART_HAL_H_
+
+#include "../../deasplay.h"
+
+#ifndef UART_DISPLAY_LINES
+#define UART_DISPLAY_LINES       1U     /**< Number of lines */
+#endif
+#ifndef UART_DISPLAY_CHARS
+#define UART_DISPLAY_CHARS      10U     /**< Number of character per lines */
+#endif
+#ifndef UART_DISPLAY_GLYPHS
+#define UART_DISPLAY_GLYPHS     16U     /**< Custom characters, up to 32 (as the LC75710 by default) */
+#endif
+
+#ifndef DEASPLAY_UART_BAUD
+#define DEASPLAY_UART_BAUD      38400UL /**< Line speed (8N1) */
+#endif
+#ifndef DEASPLAY_UART_TX_SIZE
+#define DEASPLAY_UART_TX_SIZE   32U     /**< Transmit buffer (power of two) */
+#endif
+
+#define UART_DISPLAY_RUN        0x20U   /**< Characters */
+#define UART_DISPLAY_GLYPH      0x40U   /**< Custom glyph */
+#define UART_DISPLAY_FRAME      0x60U   /**< End of a refresh */
+#define UART_DISPLAY_POWER      0x80U   /**< Power state */
+#define UART_DISPLAY_CURSOR     0xA0U   /**< Cursor visibility */
+#define UART_DISPLAY_HELLO      0xC0U   /**< Geometry, reset */
+
+void uart_display_hal_init(void);
+void uart_display_hal_power(e_deasplay_power state);
+void uart_display_hal_set_cursor(uint8_t line, uint8_t chr);
+void uart_display_hal_write_char(uint8_t chr);
+void uart_display_hal_write_run(uint8_t line, uint8_t chr, uint8_t *data, uint8_t len);
+void uart_display_hal_glyph_define(uint8_t slot, const uint8_t *rows);
+void uart_display_hal_frame_end(void);
+void uart_display_hal_cursor_visibility(bool visible);
+
+#endif /* SRC_DEASPLAY_DRIVER_UART_UART_HAL_H_ */
@@ -20,6 +20,8 @@ void fft_input (const int16_t *, complex_t *);
 void fft_execute (complex_t *);
 void fft_output (const complex_t *, uint16_t *);
 int16_t fmuls_f (int16_t, int16_t);
+uint16_t fast_usqrt32 (uint32_t);
+uint8_t fast_usqrt16 (uint16_t);
 
 #define __PROG_TYPES_COMPAT__
 #include <avr/pgmspace.h>
@@ -225,6 +227,41 @@ extern const prog_int16_t tbl_window[];
 	ror	BL
 .endm
 
+
+.macro	SQRT16	; 16bit square root (176..183clk)
+	clr	T6L
+	clr	T6H
+	ldi	BL, 1
+	clr	BH
+	ldi	DH, 8
+90:	lsl	T2L
+	rol	T2H
+	rol	T6L
+	rol	T6H
+	lsl	T2L
+	rol	T2H
+	rol	T6L
+	rol	T6H
+	brpl	91f
+	add	T6L, BL
+	adc	T6H, BH
+	rjmp	92f
+91:	sub	T6L, BL
+	sbc	T6H, BH
+92:	lsl	BL
+	rol	BH
+	andi	BL, 0b11111000
+	ori	BL, 0b00000101
+	sbrc	T6H, 7
+	subi	BL, 2
+	dec	DH
+	brne	90b
+	lsr	BH
+	ror	BL
+	lsr	BH
+	ror	BL
+.endm
+
 #endif	/* FFFT_ASM */
 
 #endif	/* FFT_N */
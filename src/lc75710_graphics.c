@@ -27,85 +27,282 @@
 #include "stdbool.h"
 #include "string.h"
 
+#include <avr/pgmspace.h>
+
 #include "deasplay/driver/LC75710/lc75710.h"
 #include "deasplay/deasplay.h"    /* display API */
+#include "deasplay/configuration.h"
+#include "lc75710_graphics.h"
 
 /**
  *
  * display_string_center
  *
- * @brief Display a string, center justified
+ * @brief Display a string, center justified. A string longer than the
+ *        line scrolls through it instead (see display_marquee()).
  *
- * @param string zero-terminated string to display
+ * @param string zero-terminated string to display, kept in place while it scrolls
  */
-void display_string_center(char* string)
+void display_string_center(const char* string)
 {
 
-    uint8_t len = 0;
+    size_t len = 0;
 
     len = strlen(string);
 
-    display_set_cursor(0, ((LC75710_DIGITS - len) / 2));
+    if (len > DEASPLAY_CHARS)
+    {
+        display_marquee(0, string, MARQUEE_STEP_US);
+    }
+    else
+    {
+        display_set_cursor(0, (uint8_t)((DEASPLAY_CHARS - len) / 2U));
+        display_write_string(string);
+    }
+
+}
+
+static uint16_t cgram_glyph[DEASPLAY_GLYPHS];      /**< Glyph held by each CGRAM slot (GLYPH_* or BARS_KEY) */
+static uint8_t cgram_lru[DEASPLAY_GLYPHS];         /**< Slots in use, most recently used first */
+static uint8_t cgram_used = 0U;                    /**< Number of slots in use */
+static uint8_t bars_horiz = GLYPH_BARS_UPPER;      /**< Horizontal bar glyphs shown by display_show_horizontal_bar() */
+
+/* Position of a glyph in the cache (cgram_used when not resident) */
+static uint8_t cgram_find(uint16_t glyph)
+{
+
+    uint8_t i = 0;
+
+    for (i = 0; i < cgram_used; i++)
+    {
+        if (cgram_glyph[cgram_lru[i]] == glyph) break;
+    }
 
-    display_write_string(string);
+    return i;
+
+}
+
+/* Position of the slot to load a new glyph into (cgram_used when all
+ * of them are on the screen or in the next frame) */
+static uint8_t cgram_victim(void)
+{
+
+    uint8_t i = 0;
+    uint32_t busy = 0;
+
+    if (cgram_used < DEASPLAY_GLYPHS)
+    {
+        /* a free slot */
+        i = cgram_used;
+        cgram_lru[i] = cgram_used;
+        cgram_used++;
+    }
+    else
+    {
+        /* the least recently used glyph neither shown nor drawn: the
+         * new bitmap reaches the chip before the next frame does */
+        busy = display_glyph_busy();
+        for (i = DEASPLAY_GLYPHS; i > 0U; i--)
+        {
+            if (((busy >> cgram_lru[i - 1U]) & 0x1U) == 0U) break;
+        }
+        i = (i > 0U) ? (i - 1U) : cgram_used;
+    }
+
+    return i;
+
+}
+
+/* Move a cache entry to the front, returns its slot */
+static uint8_t cgram_touch(uint8_t i)
+{
+
+    uint8_t slot = cgram_lru[i];
+
+    for (; i > 0U; i--)
+    {
+        cgram_lru[i] = cgram_lru[i - 1U];
+    }
+    cgram_lru[0] = slot;
+
+    return slot;
 
 }
 
 /**
  *
- * display_load_bars_vert
+ * display_glyph
  *
- * @brief Load vertical bars in the CGRAM of the chip
+ * @brief Get the character code of a custom glyph. The CGRAM slots
+ *        remember their content: a glyph is uploaded only when it is not
+ *        already in the chip, then it replaces the least recently used one
+ *        that is not on the screen.
+ *
+ * @param   glyph   glyph identifier (GLYPH_* family + index, see ma_glyphs.h)
+ * @return  the character code (CGRAM slot) showing the glyph, a space
+ *          when every slot is in use until the next frame
  *
  */
-void display_load_bars_vert(void)
+uint8_t display_glyph(uint8_t glyph)
 {
 
     uint8_t i = 0;
-    uint64_t c = 0;
+    uint8_t rows[GLYPH_ROWS];
+
+    i = cgram_find(glyph);
 
-    for (i = 0; i < 7; i++)
+    if (i < cgram_used)
     {
-        c |= (uint64_t)0x1F << (30 - (i*5));
-        lc75710_cgram_write(i, c);
+        /* hit: no serial traffic */
     }
+    else if ((i = cgram_victim()) < cgram_used)
+    {
+        cgram_glyph[cgram_lru[i]] = glyph;
+
+        /* the bitmap as is, from the flash */
+        memcpy_P(rows, g_glyph_table[glyph], GLYPH_ROWS);
+        display_glyph_define(cgram_lru[i], rows);
+    }
+    else
+    {
+        /* every slot is busy: blank until a frame frees one */
+    }
+
+    return (i < cgram_used) ? cgram_touch(i) : 0x20U;
 
 }
 
 /**
  *
- * display_load_bars_horiz
+ * bars_glyph
+ *
+ * @brief Get the character code of a BARS_PER_CHAR bars cell: the glyph
+ *        is drawn on the fly. When it is not resident and the upload
+ *        budget of the frame is spent (see display_glyph_budget()), the
+ *        resident bars glyph closest to it is used.
  *
- * @brief Load horizontal bars in the CGRAM of the chip
+ * @param   key     BARS_KEY() of the cell
+ * @return  the character code
  *
  */
-void display_load_bars_horiz(bool upper_or_lower)
+static uint8_t bars_glyph(uint16_t key)
 {
 
     uint8_t i = 0;
-    uint64_t c = 0;
-
-    for (i = 0; i < 5; i++)
+    uint8_t j = 0;
+    uint8_t bar = 0;
+    uint8_t row = 0;
+    uint8_t height = 0;
+    uint8_t peak = 0;
+    uint8_t distance = 0;
+    uint8_t best = 0xFFU;
+    uint8_t rows[GLYPH_ROWS];
+
+    i = cgram_find(key);
+
+    if (i < cgram_used)
+    {
+        /* hit, maybe from another cell of the same frame */
+    }
+    else if ((display_glyph_budget() > 0U) && ((i = cgram_victim()) < cgram_used))
     {
-        if (upper_or_lower == true)
+        cgram_glyph[cgram_lru[i]] = key;
+
+        /* rows counted from the bottom: row 1 is the last one */
+        memset(rows, 0, sizeof(rows));
+        for (bar = 0; bar < BARS_PER_CHAR; bar++)
         {
-            c |= (uint64_t)((uint64_t)0x1 << (i));
-            c |= (uint64_t)((uint64_t)0x1 << (i + 5));
-            c |= (uint64_t)((uint64_t)0x1 << (i + 10));
+            height = BARS_KEY_HEIGHT(key, bar);
+            peak = BARS_KEY_PEAK(key, bar);
+            for (row = 1; row <= GLYPH_ROWS; row++)
+            {
+                if ((row <= height) || (row == peak))
+                {
+                    rows[GLYPH_ROWS - row] |= (uint8_t)(BARS_COLUMNS << (bar * BARS_PITCH));
+                }
+            }
         }
-        else
-/*        c |= (uint64_t)((uint64_t)0x1 << (19 - i));   */ /* Split line */
+        display_glyph_define(cgram_lru[i], rows);
+    }
+    else
+    {
+        /* over budget: the closest bars on the chip */
+        i = cgram_used;
+        for (j = 0; j < cgram_used; j++)
         {
-            c |= (uint64_t)((uint64_t)0x1 << (i + 20));
-            c |= (uint64_t)((uint64_t)0x1 << (i + 25));
-            c |= (uint64_t)((uint64_t)0x1 << (i + 30));
+            if ((cgram_glyph[cgram_lru[j]] & BARS_KEY_FLAG) != 0U)
+            {
+                distance = 0U;
+                for (bar = 0; bar < BARS_PER_CHAR; bar++)
+                {
+                    height = BARS_KEY_HEIGHT(cgram_glyph[cgram_lru[j]], bar);
+                    distance += (height > BARS_KEY_HEIGHT(key, bar)) ? (height - BARS_KEY_HEIGHT(key, bar)) : (BARS_KEY_HEIGHT(key, bar) - height);
+                }
+                if (distance < best)
+                {
+                    best = distance;
+                    i = j;
+                }
+            }
         }
+    }
 
-        lc75710_cgram_write(i, c);
+    return (i < cgram_used) ? cgram_touch(i) : 0x20U;
+
+}
+
+/**
+ *
+ * display_load_glyphs
+ *
+ * @brief Make a glyph family resident in the CGRAM of the chip
+ *
+ * @param   family  first glyph of the family
+ * @param   count   number of glyphs
+ *
+ */
+static void display_load_glyphs(uint8_t family, uint8_t count)
+{
+
+    uint8_t i = 0;
+
+    for (i = 0; i < count; i++)
+    {
+        (void)display_glyph(family + i);
     }
 
 }
 
+/**
+ *
+ * display_load_bars_vert
+ *
+ * @brief Load vertical bars in the CGRAM of the chip
+ *
+ */
+void display_load_bars_vert(void)
+{
+
+    display_load_glyphs(GLYPH_BARS_VERT, 7);
+
+}
+
+/**
+ *
+ * display_load_bars_horiz
+ *
+ * @brief Load horizontal bars in the CGRAM of the chip and
+ *        select them for display_show_horizontal_bar()
+ *
+ */
+void display_load_bars_horiz(bool upper_or_lower)
+{
+
+    bars_horiz = (upper_or_lower == true) ? GLYPH_BARS_UPPER : GLYPH_BARS_LOWER;
+    display_load_glyphs(bars_horiz, 5);
+
+}
+
 /**
  *
  * display_load_vumeter_harrows
@@ -116,11 +313,7 @@ void display_load_bars_horiz(bool upper_or_lower)
 void display_load_vumeter_harrows(void)
 {
 
-    /* Arrow-like symbol */
-
-    lc75710_cgram_write(0, (uint64_t) (0xCC3));         /* Right Channel (above) */
-    lc75710_cgram_write(1, (uint64_t) 0xCC3 << 20);     /* Left Channel (below)  */
-    lc75710_cgram_write(2, (uint64_t) 0xCC3 | (uint64_t) 0xCC3 << 20);   /* R+L Channel */
+    display_load_glyphs(GLYPH_HARROWS, 3);
 
 }
 
@@ -140,22 +333,22 @@ void display_show_vumeter_harrows(uint8_t left, uint8_t right)
     uint8_t i = 0;
     uint8_t c = 0;
 
-    for (i = 1; i <= LC75710_DIGITS; i++)
+    for (i = 1; i <= DEASPLAY_CHARS; i++)
     {
         if (left >= i && right >= i)
         {
-            /* See display_load_vumeter_harrows()  */
-            c = 2;
+            /* R+L Channel */
+            c = display_glyph(GLYPH_HARROWS + 2U);
         }
         else if (right >= i)
         {
-            /* See display_load_vumeter_harrows()  */
-            c = 0;
+            /* Right Channel (above) */
+            c = display_glyph(GLYPH_HARROWS);
         }
         else if (left >= i)
         {
-            /* See display_load_vumeter_harrows()  */
-            c = 1;
+            /* Left Channel (below) */
+            c = display_glyph(GLYPH_HARROWS + 1U);
         }
         else
         {
@@ -185,12 +378,12 @@ void display_show_horizontal_bar(uint8_t level)
     {
         if (level >= 5U)
         {
-            display_write_char(4);
+            display_write_char(display_glyph(bars_horiz + 4U));
             level -= 5U;
         }
         else
         {
-            display_write_char(4U - level);
+            display_write_char(display_glyph(bars_horiz + 4U - level));
             level = 0U;
         }
     }
@@ -204,11 +397,149 @@ void display_show_horizontal_bar(uint8_t level)
  * @brief Show a vertical bar specifying its height. Position has to be
  *        set beforehand using the appropriate screen directives/driver.
  *
- * @param   level   bar level (intensity)
+ * @param   level   bar height, 0 (blank) to GLYPH_ROWS rows
  *
  */
 void display_show_vertical_bar(uint8_t level)
 {
-    if (level > 6) level = 6;
-    display_write_char(level);
+    if (level > GLYPH_ROWS) level = GLYPH_ROWS;
+    display_write_char((level == 0U) ? 0x20U : display_glyph(GLYPH_BARS_VERT + level - 1U));
+}
+
+/**
+ *
+ * display_show_bars
+ *
+ * @brief Show high resolution bars from the position that has been set
+ *        beforehand: BARS_PER_CHAR bars per character, 0 to GLYPH_ROWS
+ *        rows high, each with an optional peak dot. The glyphs are drawn
+ *        for the values to show: identical cells share one, the ones
+ *        already in the chip are not sent again and at most
+ *        DEASPLAY_GLYPH_BUDGET are uploaded per display frame, whatever
+ *        the number of calls in between.
+ *
+ * @param   levels  bar heights [rows], clipped to GLYPH_ROWS
+ * @param   peaks   peak dot rows (0: none), NULL when not used
+ * @param   count   number of bars
+ *
+ */
+void display_show_bars(const uint8_t *levels, const uint8_t *peaks, uint8_t count)
+{
+
+    uint8_t i = 0;
+    uint8_t bar = 0;
+    uint8_t height = 0;
+    uint8_t peak = 0;
+    uint16_t key = 0;
+
+    while (i < count)
+    {
+        key = BARS_KEY_FLAG;
+        for (bar = 0; bar < BARS_PER_CHAR; bar++)
+        {
+            height = 0U;
+            peak = 0U;
+            if (i < count)
+            {
+                height = (levels[i] > GLYPH_ROWS) ? GLYPH_ROWS : levels[i];
+                peak = (peaks != NULL) ? peaks[i] : 0U;
+                /* a peak dot inside the bar is not visible */
+                if ((peak <= height) || (peak > GLYPH_ROWS)) peak = 0U;
+                i++;
+            }
+            key |= BARS_KEY(bar, height, peak);
+        }
+
+        display_write_char((key == BARS_KEY_FLAG) ? 0x20U : bars_glyph(key));
+    }
+
+}
+
+/**
+ *
+ * display_load_correlation_bar
+ *
+ * @brief Load the centered correlation bar in the CGRAM of the chip
+ *
+ */
+void display_load_correlation_bar(void)
+{
+
+#if (DEASPLAY_GLYPHS >= CORRELATION_GLYPHS)
+    display_load_glyphs(GLYPH_CORRELATION, CORRELATION_GLYPHS);
+#endif
+
+}
+
+/**
+ *
+ * display_show_correlation_bar
+ *
+ * @brief Show a bar growing from the display center, to the left for
+ *        negative values and to the right for positive ones.
+ *        Position has to be set beforehand (usually 0,0).
+ *
+ * @param   level   bar length, spanning from -25 to +25 columns
+ *
+ */
+void display_show_correlation_bar(int8_t level)
+{
+
+    uint8_t i = 0;
+    int8_t n = 0;
+    uint8_t c = 0;
+
+    for (i = 0; i < DEASPLAY_CHARS; i++)
+    {
+        if (i < (DEASPLAY_CHARS / 2U))
+        {
+            /* left half: columns lit counting from the center */
+            n = (int8_t)(-level) - (int8_t)(((DEASPLAY_CHARS / 2U) - 1U - i) * 5U);
+        }
+        else
+        {
+            /* right half */
+            n = level - (int8_t)((i - (DEASPLAY_CHARS / 2U)) * 5U);
+        }
+
+#if (DEASPLAY_GLYPHS >= CORRELATION_GLYPHS)
+        if (n >= 5)
+        {
+            c = display_glyph(GLYPH_CORRELATION + CORRELATION_GLYPH_FULL);
+        }
+        else if (n > 0)
+        {
+            c = display_glyph(GLYPH_CORRELATION + ((i < (DEASPLAY_CHARS / 2U)) ? (CORRELATION_GLYPH_LEFT + n - 1) : (CORRELATION_GLYPH_RIGHT + n - 1)));
+        }
+        else if (i == ((DEASPLAY_CHARS / 2U) - 1U))
+        {
+            c = display_glyph(GLYPH_CORRELATION + CORRELATION_GLYPH_TICK_L);
+        }
+        else if (i == (DEASPLAY_CHARS / 2U))
+        {
+            c = display_glyph(GLYPH_CORRELATION + CORRELATION_GLYPH_TICK_R);
+        }
+#else
+        if (n >= 5)
+        {
+            c = CORRELATION_CHAR_FULL;
+        }
+        else if (n > 0)
+        {
+            c = CORRELATION_CHAR_PART;
+        }
+        else if ((i == ((DEASPLAY_CHARS / 2U) - 1U)) || (i == (DEASPLAY_CHARS / 2U)))
+        {
+            c = CORRELATION_CHAR_TICK;
+        }
+#endif
+        else
+        {
+            /* Space - Clear */
+            c = 0x20;
+        }
+
+        display_write_char(c);
+    }
+
 }
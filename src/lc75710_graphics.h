@@ -32,11 +32,45 @@
 #include "stdint.h"
 #include "stdbool.h"
 
+#include "ma_glyphs.h"      /* Glyph bitmaps */
+
 #define VUMETER_HARROWS_R   00U
 #define VUMETER_HARROWS_L   20U
 
+#define MARQUEE_STEP_US     300000UL    /**< Scrolling speed of display_string_center() */
+
+/* Glyph identifiers: GLYPH_* family (see ma_glyphs.h) + index.
+ * They name a bitmap, the CGRAM slot holding it is given by display_glyph() */
+
+/* High resolution bars (display_show_bars) */
+#define BARS_PER_CHAR               2U      /**< Bars in a character */
+#define BARS_COLUMNS                0x03U   /**< Columns of the first bar, the next ones are BARS_PITCH further */
+#define BARS_PITCH                  3U      /**< Columns from a bar to the next one */
+
+/* Cache identifier of a bars glyph: 3 bits of height and 3 bits of peak per bar */
+#define BARS_KEY_FLAG               0x8000U
+#define BARS_KEY(bar, height, peak) ((uint16_t)((((uint16_t)(height) << 3) | (peak)) << ((bar) * 6U)))
+#define BARS_KEY_HEIGHT(key, bar)   ((uint8_t)((key) >> (((bar) * 6U) + 3U)) & 0x7U)
+#define BARS_KEY_PEAK(key, bar)     ((uint8_t)((key) >> ((bar) * 6U)) & 0x7U)
+
+/* Correlation bar glyphs (index in the GLYPH_CORRELATION family) */
+#define CORRELATION_GLYPH_RIGHT     0U  /**< 4 glyphs, 1 to 4 columns from the left */
+#define CORRELATION_GLYPH_LEFT      4U  /**< 4 glyphs, 1 to 4 columns from the right */
+#define CORRELATION_GLYPH_FULL      8U  /**< All columns */
+#define CORRELATION_GLYPH_TICK_L    9U  /**< Center tick, left of the center */
+#define CORRELATION_GLYPH_TICK_R    10U /**< Center tick, right of the center */
+#define CORRELATION_GLYPHS          11U /**< The whole set */
+
+/* Characters of the correlation bar when the set does not fit the glyph slots
+ * (e.g. the 8 of the HD44780): it would be redefined at every frame */
+#define CORRELATION_CHAR_FULL       '='
+#define CORRELATION_CHAR_PART       '-'
+#define CORRELATION_CHAR_TICK       '|'
+
+uint8_t display_glyph(uint8_t glyph);
+
 void display_string_len(const char* string, uint8_t len);
-void display_string_center(char* string);
+void display_string_center(const char* string);
 void display_load_bars_vert(void);
 void display_load_bars_horiz(bool upper_or_lower);
 
@@ -45,5 +79,9 @@ void display_show_vumeter_harrows(uint8_t left, uint8_t right);
 
 void display_show_horizontal_bar(uint8_t level);
 void display_show_vertical_bar(uint8_t level);
+void display_show_bars(const uint8_t *levels, const uint8_t *peaks, uint8_t count);
+
+void display_load_correlation_bar(void);
+void display_show_correlation_bar(int8_t level);
 
 #endif /* SRC_LC75710_GRAPHICS_H_ */
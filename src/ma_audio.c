@@ -28,11 +28,11 @@
 
 #include <avr/io.h>
 #include <avr/interrupt.h>
-#include "math.h"
 
 #include "ffft.h"
 #include "time.h"
 #include "ma_util.h"
+#include "ma_loudness.h"
 #include "system.h"
 #include "ma_audio.h"
 
@@ -54,6 +54,18 @@ static uint16_t spektrum[FFT_N/2];      /**< Spectrum output buffer */
 static t_audio_voltage input_level;     /**< Store audio information */
 
 static bool fft_enabled = false;
+static bool loudness_enabled = false;
+static volatile bool interleaved = false;   /**< Alternate L/R on every sample (correlation meter) */
+static bool interleaved_next = false;       /**< Requested mode, applied at the next block boundary */
+
+static int32_t  corr_lr = 0;            /**< Correlation window: sum(L*R) */
+static uint32_t corr_ll = 0;            /**< Correlation window: sum(L^2) */
+static uint32_t corr_rr = 0;            /**< Correlation window: sum(R^2) */
+static uint8_t  corr_blocks = 0;        /**< Blocks in the correlation window */
+static int8_t   correlation = 0;        /**< Last correlation, -127..127 */
+
+static volatile uint8_t clip_capture = 0U;  /**< Channels clipped in the block being sampled */
+static uint8_t clip_flags = 0U;             /**< Channels clipped since the last ma_audio_clip_flags() */
 
 /**
  * ISR(ADC_vect)
@@ -84,9 +96,21 @@ ISR(ADC_vect)
         capture[capture_index] = (ADCL | (ADCH << 8U));
 #endif
 
+        /* Clip detection: flag the channel that has just been sampled */
+        if ((capture[capture_index] < MA_AUDIO_CLIP_LOW) || (capture[capture_index] > MA_AUDIO_CLIP_HIGH))
+        {
+            clip_capture |= (uint8_t)(1U << (ADMUX & (1 << MUX0)));
+        }
+
         /* Increment buffer index */
         capture_index++;
 
+        if (interleaved == true)
+        {
+            /* next sample from the other channel */
+            ADMUX ^= (1 << MUX0);
+        }
+
         /* Kick-in another conversion */
         /* Set ADSC in ADCSRA (0x7A) to start another ADC conversion */
         ADCSRA |= (1 << ADSC);
@@ -130,16 +154,89 @@ void ma_audio_init(void)
 
 }
 
-/* Quick and dirty Hann Window for post-process the FFT spectrum
- * - optimize
- * - clean
- * - ? ;=)*/
-static void hann_window(uint16_t *stream, uint8_t len)
+/**
+ *
+ * ma_audio_correlation_block
+ *
+ * @brief Process a block of interleaved L/R samples: update both RMS levels
+ *        and the correlation window. Each R sample is paired with the mean of
+ *        the two L samples around it, so the pairs are time-aligned.
+ *        Runs once per block, not in ADC_vect: the ISR starts the next
+ *        conversion, so any cycle spent there lengthens the sample period.
+ *
+ */
+static void ma_audio_correlation_block(void)
 {
-    for (uint8_t i = 1; i < len; i++)
+
+    int16_t l;
+    int16_t l_next;
+    int16_t l_mid;
+    int16_t r;
+    uint32_t lsum = 0;
+    uint32_t rsum = 0;
+    uint32_t den;
+    int32_t num;
+    uint8_t i;
+
+    l = capture[0] - 512;
+    for (i = 0; i < FFT_N; i += 2U)
+    {
+        r = capture[i + 1U] - 512;
+        lsum += (int32_t)l * l;
+        rsum += (int32_t)r * r;
+
+        if (i < (FFT_N - 2U))
+        {
+            l_next = capture[i + 2U] - 512;
+            l_mid = (l + l_next) >> 1;
+            /* multiply-accumulate per sample pair */
+            corr_lr += (int32_t)l_mid * r;
+            corr_ll += (int32_t)l_mid * l_mid;
+            corr_rr += (int32_t)r * r;
+            l = l_next;
+        }
+    }
+
+    /* FFT_N/2 samples per channel: rms = sqrt(2 * sum / FFT_N) */
+    input_level.left = (fast_usqrt32(lsum << 1U) >> 3U);
+    input_level.right = (fast_usqrt32(rsum << 1U) >> 3U);
+
+    corr_blocks++;
+    if (corr_blocks >= CORRELATION_WINDOW_BLOCKS)
+    {
+        /* normalize: sum(L*R) / sqrt(sum(L^2) * sum(R^2)) */
+        den = (uint32_t)fast_usqrt32(corr_ll) * fast_usqrt32(corr_rr);
+        num = corr_lr;
+        while (den > 0xFFFFUL)
+        {
+            den >>= 1U;
+            num >>= 1U;
+        }
+
+        if (den == 0U)
+        {
+            /* silence on (at least) one channel */
+            correlation = 0;
+        }
+        else
+        {
+            num = (num * 127L) / (int32_t)den;
+            /* the square roots are truncated: clamp */
+            if (num > 127L) num = 127L;
+            if (num < -127L) num = -127L;
+            correlation = (int8_t)num;
+        }
+
+        corr_lr = 0;
+        corr_ll = 0U;
+        corr_rr = 0U;
+        corr_blocks = 0U;
+    }
+    else
     {
-        stream[i] = 0.5f * (1.0f - cos((double)(2.0f * 3.14f * i / (len - 1.0f)))) * stream[i];
+        /* keep accumulating */
     }
+
 }
 
 /**
@@ -149,10 +246,12 @@ static void hann_window(uint16_t *stream, uint8_t len)
  * @brief This function shall be periodically called
  * on the audio buffer to compute FFT / VU-meter
  *
+ * @return  true when a new block has been processed (levels updated)
  */
-void ma_audio_process(void)
+bool ma_audio_process(void)
 {
 
+    bool processed = false;
     uint8_t old_mux;
     uint32_t rms = 0;   /* 32 bits because of the power calculations */
     uint16_t tmp = 0;
@@ -166,7 +265,6 @@ void ma_audio_process(void)
             fft_input(capture, bfly_buff);
             fft_execute(bfly_buff);
             fft_output(bfly_buff, spektrum);
-            //hann_window(spektrum, FFT_N/2);
         }
 
         /* Toggle channel */
@@ -176,54 +274,92 @@ void ma_audio_process(void)
 
         /* zero current mux option */
         ADMUX &= ~((1 << MUX3) | (1 << MUX2) | (1 << MUX1) | (1 << MUX0));
-        /* set the new mux */
-        ADMUX |= (old_mux + 1U) % 2U;
 
-        /* VU-METER testing */
-        for(i = 0; i < FFT_N; i++)
+        if (interleaved == true)
+        {
+            /* both channels in the block: always restart from the left one */
+            ma_audio_correlation_block();
+        }
+        else
         {
-            if (capture[i] >= 512)
+            /* set the new mux */
+            ADMUX |= (old_mux + 1U) % 2U;
+
+            if (loudness_enabled == true)
             {
-                tmp = (capture[i] - 512);
+                /* K-weighting and loudness windows */
+                ma_loudness_block(capture, old_mux);
             }
-            else
+
+            /* VU-METER testing */
+            for(i = 0; i < FFT_N; i++)
             {
-                tmp = (512 - capture[i]);
+                if (capture[i] >= 512)
+                {
+                    tmp = (capture[i] - 512);
+                }
+                else
+                {
+                    tmp = (512 - capture[i]);
+                }
+                rms += tmp * tmp;
             }
-            rms += tmp * tmp;
-        }
 
-        if (old_mux == 0U)
-        {
-            /* Left Channel */
+            if (old_mux == 0U)
+            {
+                /* Left Channel */
+
+                /* should be: rms / FFT_N. Therefore,
+                 * we only compute sqrt(rms) and optimize out the internal division */
+                /* MAGIC NUMBER: sqrt(FFT_N) == 8U ! */
+                input_level.left = (fast_usqrt32(rms) >> 3U);
+            }
+            else if(old_mux == 1U)
+            {
+                /* Left Right */
 
-            /* should be: rms / FFT_N. Therefore,
-             * we only compute sqrt(rms) and optimize out the internal division */
-            /* MAGIC NUMBER: sqrt(FFT_N) == 8U ! */
-            input_level.left = ((uint16_t)usqrt(rms) / 8U);
+                /* should be: rms / FFT_N. Therefore,
+                 * we only compute sqrt(rms) and optimize out the internal division */
+                /* MAGIC NUMBER: sqrt(FFT_N) == 8U ! */
+                input_level.right = (fast_usqrt32(rms) >> 3U);
+            }
+            else
+            {
+                /* Not handled */
+            }
         }
-        else if(old_mux == 1U)
-        {
-            /* Left Right */
 
-            /* should be: rms / FFT_N. Therefore,
-             * we only compute sqrt(rms) and optimize out the internal division */
-            /* MAGIC NUMBER: sqrt(FFT_N) == 8U ! */
-            input_level.right = ((uint16_t)usqrt(rms) / 8U);
+        /* Switch the capture mode only between two blocks, so that no block
+         * mixes plain and interleaved samples */
+        if (interleaved_next != interleaved)
+        {
+            corr_lr = 0;
+            corr_ll = 0U;
+            corr_rr = 0U;
+            corr_blocks = 0U;
+            correlation = 0;
+            /* both modes restart from the left channel */
+            ADMUX &= ~((1 << MUX3) | (1 << MUX2) | (1 << MUX1) | (1 << MUX0));
+            interleaved = interleaved_next;
         }
         else
         {
-            /* Not handled */
+            /* same mode */
         }
 
         /* Unset completion flag
          * NOTE: modifying shared variables is valid here,
          * no ISR shall be executed now */
+        clip_flags |= clip_capture;
+        clip_capture = 0U;
         capture_index = 0;
         ADCSRA |= (1 << ADSC);
 
+        processed = true;
     }
 
+    return processed;
+
 }
 
 /**
@@ -281,3 +417,55 @@ void ma_audio_fft_process(bool flag)
 {
     fft_enabled = flag;
 }
+
+void ma_audio_loudness_process(bool flag)
+{
+    if ((flag == true) && (loudness_enabled == false))
+    {
+        /* start measuring from scratch */
+        ma_loudness_init();
+    }
+    loudness_enabled = flag;
+}
+
+void ma_audio_correlation_process(bool flag)
+{
+    /* the block being sampled keeps its mode: see ma_audio_process() */
+    interleaved_next = flag;
+}
+
+int8_t ma_audio_correlation(void)
+{
+    return correlation;
+}
+
+/**
+ *
+ * ma_audio_clip_flags
+ *
+ * @brief Get and clear the clipped channels
+ *
+ * @return  MA_AUDIO_CLIP_LEFT / MA_AUDIO_CLIP_RIGHT bits, set when at least
+ *          one sample of the channel got closer than MA_AUDIO_CLIP_MARGIN to
+ *          the ADC rails since the last call
+ */
+uint8_t ma_audio_clip_flags(void)
+{
+    uint8_t flags = clip_flags;
+    clip_flags = 0U;
+    return flags;
+}
+
+/**
+ *
+ * ma_audio_pending
+ *
+ * @brief Tell whether a captured block is waiting for ma_audio_process().
+ *        Sampling is stopped until then: the block should be processed first.
+ *
+ * @return  true when a complete block is waiting
+ */
+bool ma_audio_pending(void)
+{
+    return (capture_index >= FFT_N);
+}
@@ -29,6 +29,18 @@
 #ifndef SRC_MA_AUDIO_H_
 #define SRC_MA_AUDIO_H_
 
+#define CORRELATION_WINDOW_BLOCKS   16U     /**< Blocks (32 sample pairs each) per correlation reading */
+
+#ifndef MA_AUDIO_CLIP_MARGIN
+#define MA_AUDIO_CLIP_MARGIN        4       /**< A sample this close to the ADC rails is a clip */
+#endif
+/* signed, as the int16_t samples they are compared with */
+#define MA_AUDIO_CLIP_LOW           (MA_AUDIO_CLIP_MARGIN)
+#define MA_AUDIO_CLIP_HIGH          (1023 - MA_AUDIO_CLIP_MARGIN)
+
+#define MA_AUDIO_CLIP_LEFT          0x1U    /**< Left channel (MUX0 clear) clipped */
+#define MA_AUDIO_CLIP_RIGHT         0x2U    /**< Right channel (MUX0 set) clipped */
+
 typedef struct _audio_voltage
 {
     uint16_t left;
@@ -36,10 +48,15 @@ typedef struct _audio_voltage
 } t_audio_voltage;
 
 void ma_audio_init(void);
-void ma_audio_process(void);
+bool ma_audio_process(void);
 uint16_t* ma_audio_spectrum(uint8_t *buckets);
 t_audio_voltage* ma_audio_last_levels(void);
 void ma_audio_fft_process(bool flag);
+void ma_audio_loudness_process(bool flag);
+void ma_audio_correlation_process(bool flag);
+int8_t ma_audio_correlation(void);
+uint8_t ma_audio_clip_flags(void);
+bool ma_audio_pending(void);
 
 void ma_audio_last_capture(uint16_t *last_capture, uint16_t *adc_min, uint16_t *adc_max);
 
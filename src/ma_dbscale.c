@@ -0,0 +1,54 @@
+
+/*
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+    Lorenzo Miori (C) 2015-2016 [ 3M4|L: memoryS60<at>gmail.com ]
+
+    Version History
+        * 1.0 initial
+
+*/
+
+/**
+ * @file ma_dbscale.c
+ * @author Lorenzo Miori
+ * @date Oct 2016
+ * @brief Voltage to dB display scales (generated by tools/dbscale.py)
+ */
+
+#include "ma_dbscale.h"
+
+/* SCALE TABLES SIZE 76 BYTES */
+const t_dbscale g_dbscale_tables[] PROGMEM =
+{
+    { .levels = 50U, .offset =   0U },
+    { .levels = 10U, .offset =  51U },
+    { .levels =  7U, .offset =  62U },
+};
+
+const uint8_t g_dbscale_thresholds[] PROGMEM =
+{
+    /* 50 levels */
+      1,   1,   2,   2,   2,   2,   2,   2,   2,   3,
+      3,   3,   3,   4,   4,   4,   5,   5,   6,   7,
+      7,   8,   9,  10,  11,  12,  13,  14,  16,  18,
+     19,  21,  24,  26,  29,  32,  36,  40,  44,  48,
+     54,  60,  66,  73,  81,  90, 100, 110, 122, 136,
+    150,
+    /* 10 levels */
+      1,   2,   3,   4,   7,  12,  19,  32,  54,  90,
+    150,
+    /* 7 levels */
+      1,   2,   4,   9,  18,  36,  73, 150,
+};
@@ -0,0 +1,52 @@
+
+/*
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+    Lorenzo Miori (C) 2015-2016 [ 3M4|L: memoryS60<at>gmail.com ]
+
+    Version History
+        * 1.0 initial
+
+*/
+
+/**
+ * @file ma_dbscale.h
+ * @author Lorenzo Miori
+ * @date Oct 2016
+ * @brief Header file for the voltage to dB display scales (generated by tools/dbscale.py)
+ */
+
+#ifndef SRC_DBSCALE_H_
+#define SRC_DBSCALE_H_
+
+#include <stdint.h>
+#include <avr/pgmspace.h>
+
+/** Describes one display scale inside the threshold table */
+typedef struct
+{
+    uint8_t levels;     /**< Display resolution (levels) */
+    uint8_t offset;     /**< First threshold in g_dbscale_thresholds */
+} t_dbscale;
+
+/* Scale identifiers (index into g_dbscale_tables) */
+#define DBSCALE_LEVELS_50      0U    /**< 50 levels display scale */
+#define DBSCALE_LEVELS_10      1U    /**< 10 levels display scale */
+#define DBSCALE_LEVELS_7       2U    /**< 7 levels display scale */
+#define DBSCALE_NUM_SCALES  3U
+
+extern const t_dbscale g_dbscale_tables[] PROGMEM;    /**< Scale descriptors (flash) */
+extern const uint8_t g_dbscale_thresholds[] PROGMEM;  /**< Ascending thresholds (flash) */
+
+#endif  /* SRC_DBSCALE_H_ */
@@ -0,0 +1,71 @@
+
+/*
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+    Lorenzo Miori (C) 2015-2016 [ 3M4|L: memoryS60<at>gmail.com ]
+
+    Version History
+        * 1.0 initial
+
+*/
+
+/**
+ * @file ma_glyphs.c
+ * @author Lorenzo Miori
+ * @date Oct 2016
+ * @brief Custom glyph bitmaps (generated by tools/glyphCify.py)
+ */
+
+#include "ma_glyphs.h"
+
+/* GLYPH TABLE SIZE 217 BYTES */
+const uint8_t g_glyph_table[][GLYPH_ROWS] PROGMEM =
+{
+    /* BARS_VERT */
+    { 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x1F },
+    { 0x00, 0x00, 0x00, 0x00, 0x00, 0x1F, 0x1F },
+    { 0x00, 0x00, 0x00, 0x00, 0x1F, 0x1F, 0x1F },
+    { 0x00, 0x00, 0x00, 0x1F, 0x1F, 0x1F, 0x1F },
+    { 0x00, 0x00, 0x1F, 0x1F, 0x1F, 0x1F, 0x1F },
+    { 0x00, 0x1F, 0x1F, 0x1F, 0x1F, 0x1F, 0x1F },
+    { 0x1F, 0x1F, 0x1F, 0x1F, 0x1F, 0x1F, 0x1F },
+    /* BARS_UPPER */
+    { 0x01, 0x01, 0x01, 0x00, 0x00, 0x00, 0x00 },
+    { 0x03, 0x03, 0x03, 0x00, 0x00, 0x00, 0x00 },
+    { 0x07, 0x07, 0x07, 0x00, 0x00, 0x00, 0x00 },
+    { 0x0F, 0x0F, 0x0F, 0x00, 0x00, 0x00, 0x00 },
+    { 0x1F, 0x1F, 0x1F, 0x00, 0x00, 0x00, 0x00 },
+    /* BARS_LOWER */
+    { 0x00, 0x00, 0x00, 0x00, 0x01, 0x01, 0x01 },
+    { 0x00, 0x00, 0x00, 0x00, 0x03, 0x03, 0x03 },
+    { 0x00, 0x00, 0x00, 0x00, 0x07, 0x07, 0x07 },
+    { 0x00, 0x00, 0x00, 0x00, 0x0F, 0x0F, 0x0F },
+    { 0x00, 0x00, 0x00, 0x00, 0x1F, 0x1F, 0x1F },
+    /* HARROWS */
+    { 0x03, 0x06, 0x03, 0x00, 0x00, 0x00, 0x00 },
+    { 0x00, 0x00, 0x00, 0x00, 0x03, 0x06, 0x03 },
+    { 0x03, 0x06, 0x03, 0x00, 0x03, 0x06, 0x03 },
+    /* CORRELATION */
+    { 0x00, 0x01, 0x01, 0x01, 0x01, 0x01, 0x00 },
+    { 0x00, 0x03, 0x03, 0x03, 0x03, 0x03, 0x00 },
+    { 0x00, 0x07, 0x07, 0x07, 0x07, 0x07, 0x00 },
+    { 0x00, 0x0F, 0x0F, 0x0F, 0x0F, 0x0F, 0x00 },
+    { 0x00, 0x10, 0x10, 0x10, 0x10, 0x10, 0x00 },
+    { 0x00, 0x18, 0x18, 0x18, 0x18, 0x18, 0x00 },
+    { 0x00, 0x1C, 0x1C, 0x1C, 0x1C, 0x1C, 0x00 },
+    { 0x00, 0x1E, 0x1E, 0x1E, 0x1E, 0x1E, 0x00 },
+    { 0x00, 0x1F, 0x1F, 0x1F, 0x1F, 0x1F, 0x00 },
+    { 0x10, 0x00, 0x00, 0x00, 0x00, 0x00, 0x10 },
+    { 0x01, 0x00, 0x00, 0x00, 0x00, 0x00, 0x01 },
+};
@@ -0,0 +1,48 @@
+
+/*
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+    Lorenzo Miori (C) 2015-2016 [ 3M4|L: memoryS60<at>gmail.com ]
+
+    Version History
+        * 1.0 initial
+
+*/
+
+/**
+ * @file ma_glyphs.h
+ * @author Lorenzo Miori
+ * @date Oct 2016
+ * @brief Header file for the custom glyph bitmaps (generated by tools/glyphCify.py)
+ */
+
+#ifndef SRC_GLYPHS_H_
+#define SRC_GLYPHS_H_
+
+#include <stdint.h>
+#include <avr/pgmspace.h>
+
+#define GLYPH_ROWS              7U    /**< Bytes per glyph: a row each, top first, bit 0 on the left */
+
+/* Glyph families (index of their first glyph in g_glyph_table) */
+#define GLYPH_BARS_VERT         0U    /**< 7 glyphs, 1 to 7 rows from the bottom */
+#define GLYPH_BARS_UPPER        7U    /**< 5 glyphs, horizontal bar on the upper rows, 1 to 5 columns */
+#define GLYPH_BARS_LOWER       12U    /**< 5 glyphs, horizontal bar on the lower rows, 1 to 5 columns */
+#define GLYPH_HARROWS          17U    /**< 3 glyphs, right / left / both arrows */
+#define GLYPH_CORRELATION      20U    /**< 11 glyphs, see CORRELATION_GLYPH_* in lc75710_graphics.h */
+#define GLYPH_NUM_IDS          31U
+
+extern const uint8_t g_glyph_table[][GLYPH_ROWS] PROGMEM;   /**< Glyph bitmaps (flash) */
+
+#endif  /* SRC_GLYPHS_H_ */
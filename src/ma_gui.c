@@ -36,6 +36,7 @@
 
 #include "time.h"
 
+#include "deasplay/deasplay.h"
 #include "lc75710_graphics.h"
 
 #include "ma_strings.h"     /* String table */
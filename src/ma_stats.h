@@ -0,0 +1,61 @@
+/*
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+    Lorenzo Miori (C) 2015-2016 [ 3M4|L: memoryS60<at>gmail.com ]
+
+    Version History
+        * 1.0 initial
+
+*/
+
+/**
+ * @file ma_stats.h
+ * @author Lorenzo Miori
+ * @date Oct 2016
+ * @brief Header file for the per-source level statistics
+ */
+
+#ifndef SRC_MA_STATS_H_
+#define SRC_MA_STATS_H_
+
+#include <stdint.h>
+#include "ma_util.h"
+
+#ifndef MA_STATS_EEPROM
+#define MA_STATS_EEPROM         1U          /**< 1: keep the statistics across power cycles */
+#endif
+#ifndef MA_STATS_EEPROM_ADDR
+#define MA_STATS_EEPROM_ADDR    16U         /**< EEPROM location, after the persistent settings */
+#endif
+#ifndef MA_STATS_COMMIT_S
+#define MA_STATS_COMMIT_S       900U        /**< EEPROM commit period [s] */
+#endif
+
+/** Level statistics of one audio source */
+typedef struct
+{
+    uint8_t  min;           /**< Lowest RMS level */
+    uint8_t  max;           /**< Highest RMS level */
+    uint32_t sum;           /**< Sum of the RMS levels (halved with count when it gets large) */
+    uint32_t count;         /**< Levels in sum */
+    uint32_t seconds;       /**< Time spent on the source [s] */
+} t_source_stats;
+
+void ma_stats_init(uint32_t timestamp);
+void ma_stats_update(uint8_t source, uint8_t level, uint32_t timestamp);
+void ma_stats_periodic(void);
+const t_source_stats* ma_stats_get(uint8_t source);
+uint8_t ma_stats_mean(uint8_t source);
+
+#endif /* SRC_MA_STATS_H_ */
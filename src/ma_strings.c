@@ -30,7 +30,7 @@
 #include "ma_strings.h"
 
 
-/* STRING SIZE 104 BYTES */
+/* STRING SIZE 206 BYTES */
 const char* g_string_table[] = 
 {
     "AUX",
@@ -49,7 +49,23 @@ const char* g_string_table[] =
     "Reboot",
     "Debug",
     "TeSt!*",
-    "0.2.0"
+    "0.2.0",
+    "Ballistics",
+    "VU",
+    "PPM",
+    "Loudness",
+    "Phase",
+    "Statistics",
+    "Min",
+    "Max",
+    "Mean",
+    "Time",
+    "Frame",
+    "Drops",
+    "Cycle",
+    "Bus",
+    "Wait",
+    "Level only"
 
 };
 
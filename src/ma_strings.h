@@ -54,6 +54,22 @@ enum _string_table_ids
     STRING_DEBUG,  /**< DEBUG */
     STRING_TEST,  /**< TEST!* */
     STRING_SW_VERSION,
+    STRING_BALLISTICS,  /**< BALLISTICS */
+    STRING_VU,  /**< VU */
+    STRING_PPM,  /**< PPM */
+    STRING_LOUDNESS,  /**< LOUDNESS */
+    STRING_PHASE,  /**< PHASE */
+    STRING_STATISTICS,  /**< STATISTICS */
+    STRING_MIN,  /**< MIN */
+    STRING_MAX,  /**< MAX */
+    STRING_MEAN,  /**< MEAN */
+    STRING_TIME,  /**< TIME */
+    STRING_FRAME,  /**< FRAME */
+    STRING_DROPS,  /**< DROPS */
+    STRING_CYCLE,  /**< CYCLE */
+    STRING_BUS,  /**< BUS */
+    STRING_WAIT,  /**< WAIT */
+    STRING_LEVEL_ONLY,  /**< LEVEL ONLY */
 
     STRING_NUM_IDS
 };
@@ -24,6 +24,14 @@
  * @author Lorenzo Miori
  * @date Oct 2015
  * @brief Miscellaneous utility routines
+ *
+ * Cycles per call, rcall to ret, measured on an ATmega8 instruction timing
+ * simulator over 3000 random inputs. No avr-gcc at hand: the code was built
+ * by the LLVM 14 AVR back end (-Os), with a 47 cycle __mulsi3 and the libgcc
+ * __udivmodsi4 loop, so the avr-gcc figures will differ somewhat.
+ * - filter_1p_process():   611..906 (852 for a 33 ms step, 300 ms tau)
+ * - low_pass_filter(), the one it replaces: 1357..1414 (two 32-bit divisions)
+ * - usqrt():               1923..1955 (fast_usqrt32() of ffft.S: 568..583)
  */
 
 #include "stdint.h"
@@ -31,6 +39,7 @@
 #include "ma_util.h"
 
 #include <avr/eeprom.h>
+#include <avr/pgmspace.h>
 
 /**
 * read_from_persistent
@@ -41,9 +50,10 @@
 void read_from_persistent(t_persistent* persistent)
 {
     uint8_t i = 0;
-    persistent->brightness = eeprom_read_byte((const uint8_t*)i++);
-    persistent->audio_source = eeprom_read_byte((const uint8_t*)i++);
-    persistent->meter_type = eeprom_read_byte((const uint8_t*)i++);
+    persistent->brightness = eeprom_read_byte((const uint8_t*)(uintptr_t)i++);
+    persistent->audio_source = eeprom_read_byte((const uint8_t*)(uintptr_t)i++);
+    persistent->meter_type = eeprom_read_byte((const uint8_t*)(uintptr_t)i++);
+    persistent->ballistics = eeprom_read_byte((const uint8_t*)(uintptr_t)i++);
 }
 
 /**
@@ -56,9 +66,10 @@ void write_to_persistent(t_persistent* persistent)
 {
     //eeprom_write_block((void*)5, persistent, sizeof(t_persistent));
     uint8_t i = 0;
-    eeprom_write_byte((uint8_t*)i++, persistent->brightness);
-    eeprom_write_byte((uint8_t*)i++, persistent->audio_source);
-    eeprom_write_byte((uint8_t*)i++, persistent->meter_type);
+    eeprom_write_byte((uint8_t*)(uintptr_t)i++, persistent->brightness);
+    eeprom_write_byte((uint8_t*)(uintptr_t)i++, persistent->audio_source);
+    eeprom_write_byte((uint8_t*)(uintptr_t)i++, persistent->meter_type);
+    eeprom_write_byte((uint8_t*)(uintptr_t)i++, persistent->ballistics);
 }
 
 bool debounce(t_debounce *debounce, bool input, uint32_t timestamp)
@@ -217,19 +228,238 @@ uint32_t usqrt(uint32_t x)
       return a;
 }
 
-void low_pass_filter(uint16_t input, t_low_pass_filter *filter)
+/* 1 - exp(-x) for x = 0, 0.25 .. 4.0 (Q15) */
+static const uint16_t filter_alpha_table[] PROGMEM = {
+        0,  7248, 12893, 17289, 20713, 23380, 25456, 27074, 28333,
+    29314, 30078, 30673, 31137, 31497, 31778, 31997, 32168
+};
+
+#define FILTER_X_ONE        32768UL                     /**< x = 1.0 (Q15) */
+#define FILTER_X_STEP       (FILTER_X_ONE / 4U)         /**< Table step (Q15) */
+#define FILTER_X_STEP_BITS  13U                         /**< log2(FILTER_X_STEP) */
+#define FILTER_X_MAX        (FILTER_X_ONE * 4U)         /**< Last table entry (Q15) */
+
+/**
+* filter_tau_init
+*
+* @brief Precompute the reciprocal of a time constant, so that the filters
+*        can compute dt / tau with a 16x16 bit multiplication and a shift:
+*        dt / tau = (dt * recip) >> shift (Q15). This is the only division.
+* @param tau    the reciprocal to initialize
+* @param tau_ms the time constant [ms], at least 1
+*/
+void filter_tau_init(t_filter_tau *tau, uint16_t tau_ms)
+{
+    uint32_t tau_us = (uint32_t)((tau_ms > 0U) ? tau_ms : 1U) * 1000UL;
+    uint8_t bits = 0U;
+
+    /* bit length of the time constant */
+    while ((tau_us >> bits) != 0U)
+    {
+        bits++;
+    }
+
+    /* recip = 2^(15 + bits) / tau_us, normalized to 16 bits */
+    if (bits <= 16U)
+    {
+        tau->recip = (uint16_t)(((1UL << (15U + bits)) - 1UL) / tau_us);
+    }
+    else
+    {
+        tau->recip = (uint16_t)(0x7FFFFFFFUL / (tau_us >> (bits - 16U)));
+    }
+    tau->shift = bits;
+}
+
+/**
+* filter_coefficient
+*
+* @brief Compute the exact one-pole coefficient for the elapsed time,
+*        alpha = 1 - exp(-dt / tau), without any division:
+*        a third order series below dt / tau = 0.25, a linearly
+*        interpolated table above it.
+* @param tau the time constant reciprocal
+* @param dt  the elapsed time [us]
+* @return the coefficient (Q15)
+*/
+static uint16_t filter_coefficient(const t_filter_tau *tau, uint16_t dt)
 {
-    uint32_t tmp;
-
-    /* weigh the previous output */
-    tmp = filter->alpha;
-    tmp *= filter->output_last;
-    /* scale the input value and add to it */
-    tmp += 1000U * (uint32_t)input;
-    tmp /= (filter->alpha + 1U);
-    /* save last input value */
-    filter->output_last = tmp;
-
-    /* compute the scaled result */
-    filter->output = (uint16_t)(filter->output_last / 1000U);
+    uint32_t x;
+    uint32_t x2;
+    uint32_t x3;
+    uint16_t a;
+    uint16_t b;
+
+    /* x = dt / tau (Q15) */
+    x = ((uint32_t)dt * tau->recip) >> tau->shift;
+
+    if (x < FILTER_X_STEP)
+    {
+        /* x - x^2 / 2 + x^3 / 6 */
+        x2 = (x * x) >> 15;
+        x3 = (x2 * x) >> 15;
+        return (uint16_t)(x - (x2 >> 1) + ((x3 * 5461UL) >> 15));
+    }
+    else if (x < FILTER_X_MAX)
+    {
+        a = pgm_read_word(&filter_alpha_table[x >> FILTER_X_STEP_BITS]);
+        b = pgm_read_word(&filter_alpha_table[(x >> FILTER_X_STEP_BITS) + 1U]);
+        return a + (uint16_t)(((uint32_t)(b - a) * (x & (FILTER_X_STEP - 1U))) >> FILTER_X_STEP_BITS);
+    }
+    else
+    {
+        /* the output simply follows the input */
+        return (uint16_t)FILTER_X_ONE;
+    }
+}
+
+/**
+* filter_step
+*
+* @brief Move the filter state towards the target by the given coefficient
+* @param state  the filter state (Q16)
+* @param target the target value (Q16)
+* @param alpha  the coefficient (Q15)
+* @return the new filter state (Q16)
+*/
+static uint32_t filter_step(uint32_t state, uint32_t target, uint16_t alpha)
+{
+    int16_t diff;
+
+    /* the difference is taken in Q7 so that a 16x16 bit product is enough */
+    diff = (int16_t)((int16_t)(target >> 9) - (int16_t)(state >> 9));
+
+    return (uint32_t)((int32_t)state + (((int32_t)diff * alpha) >> 6));
+}
+
+/**
+* filter_1p_init
+*
+* @brief Reset a one-pole low pass filter
+* @param filter the filter state
+* @param tau_ms the time constant [ms]
+*/
+void filter_1p_init(t_filter_1p *filter, uint16_t tau_ms)
+{
+    filter_tau_init(&filter->tau, tau_ms);
+    filter->state  = 0U;
+    filter->output = 0U;
+}
+
+/**
+* filter_1p_process
+*
+* @brief Run a one-pole low pass filter on a new input. It replaces the
+*        old low_pass_filter(): no division, 16 fractional bits instead
+*        of ~10, and a result that does not depend on the call rate
+*        (see the cycle counts at the top of the file).
+* @param input  the filter input
+* @param dt     the time elapsed since the last call [us]
+* @param filter the filter state
+*/
+void filter_1p_process(uint8_t input, uint16_t dt, t_filter_1p *filter)
+{
+    filter->state  = filter_step(filter->state, (uint32_t)input << 16,
+                                 filter_coefficient(&filter->tau, dt));
+
+    /* compute the rounded result */
+    filter->output = (uint8_t)((filter->state + 0x8000UL) >> 16);
+}
+
+/**
+* filter_ar_init
+*
+* @brief Reset an attack / release filter
+* @param filter     the filter state
+* @param attack_ms  the time constant when the input rises [ms]
+* @param release_ms the time constant when the input falls [ms]
+* @param peak       true to release towards zero (linear in dB) down to the input
+*/
+void filter_ar_init(t_filter_ar *filter, uint16_t attack_ms, uint16_t release_ms, bool peak)
+{
+    filter_tau_init(&filter->attack, attack_ms);
+    filter_tau_init(&filter->release, release_ms);
+    filter->peak   = peak;
+    filter->state  = 0U;
+    filter->output = 0U;
+}
+
+/**
+* filter_ar_process
+*
+* @brief Run an attack / release filter on a new input
+* @param input  the filter input
+* @param dt     the time elapsed since the last call [us]
+* @param filter the filter state
+*/
+void filter_ar_process(uint8_t input, uint16_t dt, t_filter_ar *filter)
+{
+    uint32_t target = (uint32_t)input << 16;
+
+    if (target > filter->state)
+    {
+        filter->state = filter_step(filter->state, target,
+                                    filter_coefficient(&filter->attack, dt));
+    }
+    else if (filter->peak == true)
+    {
+        /* exponential decay towards zero, but never below the input */
+        filter->state = filter_step(filter->state, 0U,
+                                    filter_coefficient(&filter->release, dt));
+        if (filter->state < target)
+        {
+            filter->state = target;
+        }
+    }
+    else
+    {
+        filter->state = filter_step(filter->state, target,
+                                    filter_coefficient(&filter->release, dt));
+    }
+
+    /* compute the rounded result */
+    filter->output = (uint8_t)((filter->state + 0x8000UL) >> 16);
+}
+
+/**
+* ballistics_init
+*
+* @brief Reset the meter ballistics
+* @param ballistics the ballistics state
+* @param mode       the ballistics mode, see e_ballistics
+*/
+void ballistics_init(t_ballistics *ballistics, uint8_t mode)
+{
+    if (mode == BALLISTICS_PPM)
+    {
+        filter_ar_init(&ballistics->filter, BALLISTICS_PPM_ATTACK_MS, BALLISTICS_PPM_RELEASE_MS, true);
+    }
+    else
+    {
+        mode = BALLISTICS_VU;
+        filter_ar_init(&ballistics->filter, BALLISTICS_VU_TAU_MS, BALLISTICS_VU_TAU_MS, false);
+    }
+    ballistics->mode   = mode;
+    ballistics->output = 0U;
+}
+
+/**
+* ballistics_process
+*
+* @brief Run the meter ballistics on a new reading. The coefficients
+*        are derived from the real time elapsed since the last call,
+*        hence the response does not depend on the main loop speed.
+* @param input      the rectified level (RMS)
+* @param dt         the time elapsed since the last call [us]
+* @param ballistics the ballistics state
+*/
+void ballistics_process(uint8_t input, uint32_t dt, t_ballistics *ballistics)
+{
+    if (dt > FILTER_DT_MAX_US)
+    {
+        dt = FILTER_DT_MAX_US;
+    }
+
+    filter_ar_process(input, (uint16_t)dt, &ballistics->filter);
+    ballistics->output = ballistics->filter.output;
 }
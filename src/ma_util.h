@@ -37,6 +37,7 @@ typedef struct
     uint8_t brightness;     /**< Display brightness */
     uint8_t audio_source;   /**< Last used audio source */
     uint8_t meter_type;     /**< Preferred meter type */
+    uint8_t ballistics;     /**< Meter ballistics: one bit per meter type, set for PPM */
 } t_persistent;
 
 typedef struct
@@ -48,16 +49,63 @@ typedef struct
 
 } t_debounce;
 
+/** Reciprocal of a filter time constant, see filter_tau_init() */
 typedef struct
 {
-    uint16_t output;
-    uint16_t alpha;
+    uint16_t recip;         /**< Reciprocal mantissa */
+    uint8_t  shift;         /**< Reciprocal shift */
+} t_filter_tau;
 
-    uint32_t output_last;
-} t_low_pass_filter;
+/** One-pole low pass filter */
+typedef struct
+{
+    t_filter_tau tau;       /**< Time constant */
+    uint32_t     state;     /**< Filter state (Q16) */
+    uint8_t      output;    /**< Filter output */
+} t_filter_1p;
+
+/** Attack / release filter */
+typedef struct
+{
+    t_filter_tau attack;    /**< Time constant when the input rises */
+    t_filter_tau release;   /**< Time constant when the input falls */
+    bool         peak;      /**< Release towards zero (linear in dB) instead of towards the input */
+    uint32_t     state;     /**< Filter state (Q16) */
+    uint8_t      output;    /**< Filter output */
+} t_filter_ar;
+
+#define FILTER_DT_MAX_US    65535UL     /**< Longest update interval taken into account */
+
+/** Meter ballistics */
+typedef enum
+{
+    BALLISTICS_VU,      /**< VU: symmetric integration, 99% of a step in 300ms */
+    BALLISTICS_PPM,     /**< PPM: fast attack, linear-in-dB release */
+
+    BALLISTICS_TOTAL
+} e_ballistics;
+
+#define BALLISTICS_VU_TAU_MS          65U     /**< 300ms / ln(100) */
+#define BALLISTICS_PPM_ATTACK_MS       3U     /**< 80% of a step in 5ms (IEC 60268-10 type I) */
+#define BALLISTICS_PPM_RELEASE_MS    651U     /**< 20dB fall in 1.5s */
+
+typedef struct
+{
+    uint8_t     mode;       /**< Ballistics mode, see e_ballistics */
+    t_filter_ar filter;     /**< Meter integrator */
+    uint8_t     output;     /**< Meter reading */
+} t_ballistics;
 
 #define SOURCE_MAX    4         /**< Number of audio sources */
 
+/** Clip indicator and counters */
+typedef struct
+{
+    uint16_t counters[SOURCE_MAX];  /**< Clip events, per audio source */
+    uint32_t timestamp;             /**< Time of the last clip event */
+    uint8_t  latched;               /**< Channels shown as clipped (MA_AUDIO_CLIP_* bits) */
+} t_clip;
+
 /* EEPROM */
 void read_from_persistent(t_persistent* persistent);
 void write_to_persistent(t_persistent* persistent);
@@ -70,7 +118,13 @@ uint8_t source_select(uint8_t source);
 
 /* Algorithms */
 uint32_t usqrt(uint32_t x);
-void low_pass_filter(uint16_t input, t_low_pass_filter *filter);
+void filter_tau_init(t_filter_tau *tau, uint16_t tau_ms);
+void filter_1p_init(t_filter_1p *filter, uint16_t tau_ms);
+void filter_1p_process(uint8_t input, uint16_t dt, t_filter_1p *filter);
+void filter_ar_init(t_filter_ar *filter, uint16_t attack_ms, uint16_t release_ms, bool peak);
+void filter_ar_process(uint8_t input, uint16_t dt, t_filter_ar *filter);
+void ballistics_init(t_ballistics *ballistics, uint8_t mode);
+void ballistics_process(uint8_t input, uint32_t dt, t_ballistics *ballistics);
 
 #endif
 
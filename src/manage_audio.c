@@ -27,6 +27,7 @@
  */
 
 #include "deasplay/deasplay.h"
+#include "deasplay/configuration.h"
 #include "deasplay/driver/LC75710/lc75710.h"    /* LC75710 low-level */
 #include "lc75710_graphics.h"
 #include "time.h"
@@ -44,15 +45,17 @@
 #include <util/delay.h>
 #include <avr/pgmspace.h>
 
-/* UART */
-#include "uart.h"
 #include "ma_audio.h"
 #include "system.h"
 #include "ma_strings.h"
+#include "ma_dbscale.h"
+#include "ma_loudness.h"
+#include "ma_stats.h"
 
 /* Globals */
 static t_operational operational;          /**< Global operational state */
 static t_persistent persistent;     /**< Persistent app state */
+static t_clip clip;                 /**< Clip indicator state */
 
 
 /* PIN definitions */
@@ -67,8 +70,54 @@ static t_persistent persistent;     /**< Persistent app state */
 #define KEY_2       PB1
 #define KEY_3       PB2
 
+#if defined(DEASPLAY_LC75710) && (LC75710_SPI == 1U) && (KEY_3 == PB2)
+/* KEY_3 would pull SS low and drop the SPI out of master mode mid transfer */
+#error "LC75710_SPI needs KEY_3 off PB2 (the SPI SS pin)"
+#endif
+
+/* Clip indicator */
+#define CLIP_HOLD_US        2000000UL   /**< The indicator keeps blinking this long after the last clip */
+#define CLIP_BLINK_MS       350U        /**< Blink period of the indicator [ms] */
+#define CLIP_COUNTER_MAX    9999U       /**< Counters saturate (4 digits on the debug page) */
+#define CLIP_HALF           (DEASPLAY_CHARS / 2U)   /**< Left channel: first half of the line, right: second half */
+
+#define SOURCE_OVERLAY_US   2000000UL   /**< The selected source name stays over the meter this long */
+#define NOTICE_OVERLAY_US   1500000UL   /**< A menu notice stays over the entry this long */
+
+/* Spectrum meter */
+#define FFT_BARS            20U         /**< Bars, 1 or 2 bins each: up to (FFT_N / 2 - 1) * 2 / 3 */
+#define FFT_PEAK_FALL_US    150000UL    /**< The peak dots fall a row this often */
+
+#define DEBUG_VIEW_FRAME    (SOURCE_MAX)        /**< Debug page: longest display frame [us] */
+#define DEBUG_VIEW_DROPS    (SOURCE_MAX + 1U)   /**< Debug page: dropped display frames */
+#define DEBUG_VIEW_CYCLE    (SOURCE_MAX + 2U)   /**< Debug page: main loop cycle time [us] */
+#ifdef DEASPLAY_BUS_STATS
+#define DEBUG_VIEW_BUS      (SOURCE_MAX + 3U)   /**< Debug page: display bus bytes in the last second */
+#define DEBUG_VIEW_WAIT     (SOURCE_MAX + 4U)   /**< Debug page: display bus waits in the last second [us] */
+#define DEBUG_VIEW_LAST     DEBUG_VIEW_WAIT
+#else
+#define DEBUG_VIEW_LAST     DEBUG_VIEW_CYCLE
+#endif
+#define DEBUG_VALUE_MAX     9999U               /**< 4 digits on the debug page */
+#define DEBUG_VALUE_FORMAT  (4U | DEASPLAY_ALIGN_RIGHT)     /**< Right aligned on the last 4 characters */
+
+typedef enum
+{
+    METER_VU_LINES_HORIZ,
+    METER_VU_HARROW_HORIZ,
+    METER_FFT_VERTICAL,
+    METER_LOUDNESS,
+    METER_CORRELATION,
+
+    METER_TOTAL_METERS
+} e_meter_type;
+
+/* Only the level meters run the RMS levels through the ballistics */
+#define METER_HAS_BALLISTICS(type)  ((type) <= METER_VU_HARROW_HORIZ)
+
 /* Local function declaration */
 
+static void ma_gui_overlay_center(uint8_t label, uint32_t duration);
 static t_menu_page* ma_gui_source_select(uint8_t reason, uint8_t id, t_menu_page* page);
 static t_menu_page* ma_gui_menu_goto_sett_display(uint8_t reason, uint8_t id, t_menu_page* page);
 static t_menu_page* ma_gui_menu_goto_sett_brightness(uint8_t reason, uint8_t id, t_menu_page* page);
@@ -77,6 +126,10 @@ static t_menu_page* ma_gui_menu_set_meter(uint8_t reason, uint8_t id, t_menu_pag
 static t_menu_page* ma_gui_menu_goto_tools(uint8_t reason, uint8_t id, t_menu_page* page);
 static t_menu_page* ma_gui_menu_tools_selection(uint8_t reason, uint8_t id, t_menu_page* page);
 static t_menu_page* ma_gui_menu_goto_sett_meters(uint8_t reason, uint8_t id, t_menu_page* page);
+static t_menu_page* ma_gui_menu_goto_sett_ballistics(uint8_t reason, uint8_t id, t_menu_page* page);
+static t_menu_page* ma_gui_menu_set_ballistics(uint8_t reason, uint8_t id, t_menu_page* page);
+static t_menu_page* ma_gui_menu_debug_selection(uint8_t reason, uint8_t id, t_menu_page* page);
+static t_menu_page* ma_gui_menu_stats_selection(uint8_t reason, uint8_t id, t_menu_page* page);
 
 static void ma_gui_settings_brightness_pre(uint8_t reason);
 static void ma_gui_source_select_pre(uint8_t reason);
@@ -142,11 +195,15 @@ static t_menu_page PAGE_SETTINGS_BRIGHTNESS = {
     .elements = sizeof(MENU_SETTINGS_BRIGHTNESS) / sizeof(t_menu_entry)
 };
 
+/* NOTE: meter entries are in e_meter_type order */
 static t_menu_entry  MENU_SETTINGS_METER[] =
 {
-        { .label = STRING_FFT,      .cb = &ma_gui_menu_set_meter  },
         { .label = STRING_VU_LINE, .cb = &ma_gui_menu_set_meter  },
         { .label = STRING_VU_HARROW,  .cb = &ma_gui_menu_set_meter  },
+        { .label = STRING_FFT,      .cb = &ma_gui_menu_set_meter  },
+        { .label = STRING_LOUDNESS, .cb = &ma_gui_menu_set_meter  },
+        { .label = STRING_PHASE,    .cb = &ma_gui_menu_set_meter  },
+        { .label = STRING_BALLISTICS, .cb = &ma_gui_menu_goto_sett_ballistics  },
         { .label = STRING_BACK,     .cb = &ma_gui_menu_goto_previous },
 };
 
@@ -157,9 +214,25 @@ static t_menu_page PAGE_SETTINGS_METER = {
     .elements = sizeof(MENU_SETTINGS_METER) / sizeof(t_menu_entry)
 };
 
+/* NOTE: entries are in e_ballistics order */
+static t_menu_entry  MENU_SETTINGS_BALLISTICS[] =
+{
+        { .label = STRING_VU,       .cb = &ma_gui_menu_set_ballistics  },
+        { .label = STRING_PPM,      .cb = &ma_gui_menu_set_ballistics  },
+        { .label = STRING_BACK,     .cb = &ma_gui_menu_goto_previous },
+};
+
+static t_menu_page PAGE_SETTINGS_BALLISTICS = {
+    .page_previous = &PAGE_SETTINGS_METER,
+    .pre_post     = NULL,
+    .entries = MENU_SETTINGS_BALLISTICS,
+    .elements = sizeof(MENU_SETTINGS_BALLISTICS) / sizeof(t_menu_entry)
+};
+
 static t_menu_entry  MENU_SETTINGS_TOOLS[] = {
         { .label = STRING_SW_VERSION, .cb = &ma_gui_menu_tools_selection },
         { .label = STRING_REBOOT, .cb = &ma_gui_menu_tools_selection },
+        { .label = STRING_STATISTICS, .cb = &ma_gui_menu_tools_selection },
         { .label = STRING_BACK,   .cb = &ma_gui_menu_goto_previous },
 };
 
@@ -170,13 +243,40 @@ static t_menu_page PAGE_SETTINGS_TOOLS = {
     .elements = sizeof(MENU_SETTINGS_TOOLS) / sizeof(t_menu_entry)
 };
 
+/* NOTE: entries are in MENU_SOURCE order */
+static t_menu_entry  MENU_STATISTICS[] = {
+        { .label = STRING_AUX,    .cb = &ma_gui_menu_stats_selection },
+        { .label = STRING_RADIO,  .cb = &ma_gui_menu_stats_selection },
+        { .label = STRING_CD,     .cb = &ma_gui_menu_stats_selection },
+        { .label = STRING_TAPE,   .cb = &ma_gui_menu_stats_selection },
+        { .label = STRING_BACK,   .cb = &ma_gui_menu_goto_previous },
+};
+
+static t_menu_page PAGE_STATISTICS = {
+    .page_previous = &PAGE_SETTINGS_TOOLS,
+    .pre_post     = NULL,
+    .entries = MENU_STATISTICS,
+    .elements = sizeof(MENU_STATISTICS) / sizeof(t_menu_entry)
+};
+
+/* Statistics fields, shown in turn */
+static const uint8_t STATS_LABELS[] = { STRING_MIN, STRING_MAX, STRING_MEAN, STRING_TIME };
+
+/* NOTE: the first entries are the clip counters, in MENU_SOURCE order,
+ * followed by the display frame counters, the cycle time and the display
+ * bus counters when built in (DEBUG_VIEW_*) */
 static t_menu_entry MENU_DEBUG[] = {
-                {.label = STRING_NUM_IDS, .cb = NULL},
-                {.label = STRING_NUM_IDS, .cb = NULL},
-                {.label = STRING_NUM_IDS, .cb = NULL},
-                {.label = STRING_NUM_IDS, .cb = NULL},
-                {.label = STRING_NUM_IDS, .cb = NULL},
-                {.label = STRING_NUM_IDS, .cb = NULL},
+                {.label = STRING_AUX,     .cb = &ma_gui_menu_debug_selection},
+                {.label = STRING_RADIO,   .cb = &ma_gui_menu_debug_selection},
+                {.label = STRING_CD,      .cb = &ma_gui_menu_debug_selection},
+                {.label = STRING_TAPE,    .cb = &ma_gui_menu_debug_selection},
+                {.label = STRING_FRAME,   .cb = &ma_gui_menu_debug_selection},
+                {.label = STRING_DROPS,   .cb = &ma_gui_menu_debug_selection},
+                {.label = STRING_CYCLE,   .cb = &ma_gui_menu_debug_selection},
+#ifdef DEASPLAY_BUS_STATS
+                {.label = STRING_BUS,     .cb = &ma_gui_menu_debug_selection},
+                {.label = STRING_WAIT,    .cb = &ma_gui_menu_debug_selection},
+#endif
                 { .label = STRING_BACK, .cb = &ma_gui_menu_goto_previous },
 };
 
@@ -187,109 +287,58 @@ static t_menu_page PAGE_DEBUG = {
         .elements = sizeof(MENU_DEBUG) / sizeof(t_menu_entry)
 };
 
-static const uint8_t voltage_to_display_dB_scale_table[] = {
-        150,
-        136,
-        122,
-        110,
-        100,
-        90,
-        81,
-        73,
-        66,
-        60,
-        54,
-        48,
-        44,
-        40,
-        36,
-        32,
-        29,
-        26,
-        24,
-        21,
-        19,
-        18,
-        16,
-        14,
-        13,
-        12,
-        11,
-        10,
-        9,
-        8,
-        7,
-        7,
-        6,
-        5,
-        5,
-        4,
-        4,
-        4,
-        3,
-        3,
-        3,
-        3,
-        2,
-        2,
-        2,
-        2,
-        2,
-        2,
-        2,
-        1,
-        1
-};
-
-#define V2DB_LOOKUP_SIZE    (sizeof(voltage_to_display_dB_scale_table) / sizeof(voltage_to_display_dB_scale_table[0]))
-
-
 /* Visualizations static data */
-static t_low_pass_filter lrms_filter;
-static t_low_pass_filter rrms_filter;
+static t_ballistics lrms_ballistics;
+static t_ballistics rrms_ballistics;
+static uint8_t debug_view;          /**< Debug page entry being shown */
+static uint8_t stats_view;          /**< Statistics page entry being shown */
+static uint8_t stats_field;         /**< Statistics field being shown (0: source name) */
+static uint8_t stats_ticks;         /**< 50ms ticks the field has been shown for */
 
-static uint8_t voltage_to_display_dB(uint8_t value, uint8_t display)
+/**
+ * voltage_to_display_dB
+ *
+ * @brief Convert an RMS voltage to the logarithmic display scale.
+ *        The thresholds live in flash (see tools/dbscale.py) and are
+ *        binary-searched: at most 6 probes for the 50 levels scale.
+ *
+ * @param value     the RMS voltage (ADC units)
+ * @param scale     the display scale, one of the DBSCALE_LEVELS_* identifiers
+ *
+ * @return the display level, 0..levels + 1
+ */
+static uint8_t voltage_to_display_dB(uint8_t value, uint8_t scale)
 {
-    uint8_t retval;
-    uint8_t i;
-    uint8_t display_counts;
-    uint8_t steps;
-
-    display_counts = display + 1U;
+    uint8_t low;
+    uint8_t high;
+    uint8_t mid;
+    uint8_t offset;
 
-    if (display == 50U)
-    {
-        steps = 1U;
-    }
-    else if (display == 10U)
-    {
-        steps = 5U;
-    }
-    else if (display == 7U)
-    {
-        steps = 7U;
-    }
-    else
+    if (scale >= DBSCALE_NUM_SCALES)
     {
         /* safe "undefined" behavior */
-        steps = 0U;
-        display_counts = 0U;
+        return 0U;
     }
 
-    /* linear search through the values */
-    for (i = 0U; i < V2DB_LOOKUP_SIZE; i += steps)
+    offset = pgm_read_byte(&g_dbscale_tables[scale].offset);
+    low = 0U;
+    high = pgm_read_byte(&g_dbscale_tables[scale].levels) + 1U;
+
+    /* count the (ascending) thresholds lower than or equal to the value */
+    while (low < high)
     {
-        if (value >= voltage_to_display_dB_scale_table[i])
+        mid = (low + high) >> 1U;
+        if (pgm_read_byte(&g_dbscale_thresholds[offset + mid]) <= value)
         {
-            break;
+            low = mid + 1U;
         }
         else
         {
-            display_counts--;
+            high = mid;
         }
     }
 
-    return display_counts;
+    return low;
 
 }
 
@@ -313,6 +362,22 @@ static void ma_gui_source_select_pre(uint8_t reason)
     }
 }
 
+/* Show a string, centered on the first line, over whatever is displayed */
+static void ma_gui_overlay_center(uint8_t label, uint32_t duration)
+{
+
+    char overlay[DEASPLAY_CHARS + 1U];
+    uint8_t len;
+
+    len = strlen(g_string_table[label]);
+    if (len > DEASPLAY_CHARS) len = DEASPLAY_CHARS;
+    memset(overlay, ' ', DEASPLAY_CHARS);
+    memcpy(&overlay[(DEASPLAY_CHARS - len) >> 1U], g_string_table[label], len);
+    overlay[DEASPLAY_CHARS] = '\0';
+    display_overlay(0, 0, overlay, duration);
+
+}
+
 static t_menu_page* ma_gui_source_select(uint8_t reason, uint8_t id, t_menu_page* page)
 {
 
@@ -321,6 +386,9 @@ static t_menu_page* ma_gui_source_select(uint8_t reason, uint8_t id, t_menu_page
         persistent.audio_source = id;
         operational.output.relays = source_select(id);
         write_to_persistent(&persistent);
+
+        /* keep the source name, centered, over the meter for a while */
+        ma_gui_overlay_center(MENU_SOURCE[id].label, SOURCE_OVERLAY_US);
     }
     else if (reason == REASON_SELECT)
     {
@@ -376,6 +444,42 @@ static t_menu_page* ma_gui_menu_set_meter(uint8_t reason, uint8_t id, t_menu_pag
     return ma_gui_menu_goto_previous(reason, id, page);
 }
 
+static t_menu_page* ma_gui_menu_goto_sett_ballistics(uint8_t reason, uint8_t id, t_menu_page* page)
+{
+    if (reason != REASON_SELECT)
+    {
+        return NULL;
+    }
+    else if (METER_HAS_BALLISTICS(persistent.meter_type))
+    {
+        return &PAGE_SETTINGS_BALLISTICS;
+    }
+    else
+    {
+        /* nothing to set for the other meters: say so instead of ignoring the key */
+        ma_gui_overlay_center(STRING_LEVEL_ONLY, NOTICE_OVERLAY_US);
+        return NULL;
+    }
+}
+
+static t_menu_page* ma_gui_menu_set_ballistics(uint8_t reason, uint8_t id, t_menu_page* page)
+{
+    if ((reason == REASON_SELECT) && METER_HAS_BALLISTICS(persistent.meter_type))
+    {
+        /* the ballistics apply to the selected meter only */
+        if (id == BALLISTICS_PPM)
+        {
+            persistent.ballistics |= (uint8_t)(1U << persistent.meter_type);
+        }
+        else
+        {
+            persistent.ballistics &= (uint8_t)~(1U << persistent.meter_type);
+        }
+        write_to_persistent(&persistent);
+    }
+    return ma_gui_menu_goto_previous(reason, id, page);
+}
+
 static t_menu_page* ma_gui_menu_goto_tools(uint8_t reason, uint8_t id, t_menu_page* page)
 {
     if (reason == REASON_SELECT)
@@ -396,6 +500,8 @@ static t_menu_page* ma_gui_menu_tools_selection(uint8_t reason, uint8_t id, t_me
             case 1:
                 system_reset();
                 break;
+            case 2:
+                return &PAGE_STATISTICS;
             default:
                 break;
         }
@@ -405,29 +511,128 @@ static t_menu_page* ma_gui_menu_tools_selection(uint8_t reason, uint8_t id, t_me
 
 }
 
-static void ma_gui_visu_fft(bool init)
+static t_menu_page* ma_gui_menu_debug_selection(uint8_t reason, uint8_t id, t_menu_page* page)
 {
 
+    if (reason == REASON_HOOVER)
+    {
+        debug_view = id;
+    }
+    else if ((reason == REASON_SELECT) && (id < SOURCE_MAX))
+    {
+        /* reset the clip counter */
+        clip.counters[id] = 0U;
+    }
+    else if ((reason == REASON_SELECT) && (id == DEBUG_VIEW_FRAME))
+    {
+        display_frame_stats()->time_max = 0U;
+    }
+    else if ((reason == REASON_SELECT) && (id == DEBUG_VIEW_DROPS))
+    {
+        display_frame_stats()->dropped = 0U;
+    }
+
+    return NULL;
+
+}
+
+static t_menu_page* ma_gui_menu_stats_selection(uint8_t reason, uint8_t id, t_menu_page* page)
+{
+
+    if (reason == REASON_HOOVER)
+    {
+        /* start from the source name, drawn by the menu */
+        stats_view = id;
+        stats_field = 0U;
+        stats_ticks = 0U;
+    }
+
+    return NULL;
+
+}
+
+/**
+* ma_gui_visu_stats
+*
+* @brief Show one statistics field of a source, e.g. "Mean    40" or "Time  12h"
+* @param source the audio source
+* @param field  0: source name, then the STATS_LABELS fields
+*/
+static void ma_gui_visu_stats(uint8_t source, uint8_t field)
+{
+
+    const t_source_stats *stats = ma_stats_get(source);
+    uint32_t hours;
+
+    display_clean();
+
+    if ((stats == NULL) || (field == 0U))
+    {
+        display_string_center(g_string_table[MENU_SOURCE[source].label]);
+    }
+    else
+    {
+        display_set_cursor(0,0);
+        display_write_string(g_string_table[STATS_LABELS[field - 1U]]);
+        display_set_cursor(0,6);
+
+        switch(field)
+        {
+            case 1:
+                display_write_unsigned((stats->count != 0U) ? stats->min : 0U, 0U, DEBUG_VALUE_FORMAT, NULL);
+                break;
+            case 2:
+                display_write_unsigned(stats->max, 0U, DEBUG_VALUE_FORMAT, NULL);
+                break;
+            case 3:
+                display_write_unsigned(ma_stats_mean(source), 0U, DEBUG_VALUE_FORMAT, NULL);
+                break;
+            default:
+                display_set_cursor(0,5);
+                if (stats->seconds < (600UL * 60UL))
+                {
+                    display_write_unsigned((uint16_t)(stats->seconds / 60UL), 0U, 5U | DEASPLAY_ALIGN_RIGHT, "m");
+                }
+                else
+                {
+                    /* the totals are kept in the EEPROM: they can grow past 4 digits */
+                    hours = stats->seconds / 3600UL;
+                    display_write_unsigned((hours > DEBUG_VALUE_MAX) ? DEBUG_VALUE_MAX : (uint16_t)hours, 0U, 5U | DEASPLAY_ALIGN_RIGHT, "h");
+                }
+                break;
+        }
+    }
 
 }
 
 /*
     display_set_cursor(0,0);
     display_clean();
-    display_write_number(voltage_to_display_dB((uint8_t)levels->left, 50U), false);
+    display_write_number(voltage_to_display_dB((uint8_t)levels->left, DBSCALE_LEVELS_50), false);
     display_write_char('-');
-    display_write_number(voltage_to_display_dB((uint8_t)levels->right, 50U), false);
+    display_write_number(voltage_to_display_dB((uint8_t)levels->right, DBSCALE_LEVELS_50), false);
     return;
 */
 
-typedef enum
+/**
+* ma_gui_write_lu
+*
+* @brief Write a loudness reading at the cursor position
+* @param lu the loudness [LU]
+*/
+static void ma_gui_write_lu(int8_t lu)
 {
-    METER_VU_LINES_HORIZ,
-    METER_VU_HARROW_HORIZ,
-    METER_FFT_VERTICAL,
-
-    METER_TOTAL_METERS
-} e_meter_type;
+    if (lu <= LOUDNESS_FLOOR_LU)
+    {
+        /* no signal */
+        display_write_char('-');
+        display_write_char('-');
+    }
+    else
+    {
+        display_write_value(lu, 0U, DEASPLAY_SIGN, NULL);
+    }
+}
 
 static void ma_gui_visu_vumeter(bool init, uint8_t type)
 {
@@ -443,25 +648,49 @@ static void ma_gui_visu_vumeter(bool init, uint8_t type)
 
     static uint8_t left_or_right = 0U;
     static uint8_t pause = 0U;
+    static uint32_t frame_timestamp = 0U;
+    static uint8_t fft_peaks[FFT_BARS];
+    static uint32_t fft_peaks_timestamp = 0U;
+    uint32_t frame_interval;
+    uint8_t ballistics;
+    int8_t momentary;
+    int8_t short_term;
+    int8_t corr;
+    int8_t corr_columns;
+    uint8_t bars[FFT_BARS];
+    uint8_t bin;
+    uint16_t sum;
+    bool peaks_fall;
 
     if (init == false)
     {
 
-        /* configure the filters */
-        rrms_filter.alpha       = 100U;
-        rrms_filter.output_last = 0U;
-        lrms_filter.alpha       = 100U;
-        lrms_filter.output_last = 0U;
+        /* configure the ballistics of the selected meter */
+        ballistics = ((persistent.ballistics >> type) & 0x1U) ? BALLISTICS_PPM : BALLISTICS_VU;
+        ballistics_init(&lrms_ballistics, ballistics);
+        ballistics_init(&rrms_ballistics, ballistics);
+        frame_timestamp = g_timestamp;
 
         /* reset internal state */
         left_or_right = 0U;
 
+        /* K-weighting only when needed */
+        ma_audio_loudness_process(type == METER_LOUDNESS);
+        /* sample L/R interleaved only when needed */
+        ma_audio_correlation_process(type == METER_CORRELATION);
+
         if (type == METER_FFT_VERTICAL)
         {
             /* process FFT */
             ma_audio_fft_process(true);
+            /* the bar glyphs are drawn on the fly */
+        }
+        else if (type == METER_CORRELATION)
+        {
+            /* do not process FFT */
+            ma_audio_fft_process(false);
             /* load the characters */
-            display_load_bars_vert();
+            display_load_correlation_bar();
         }
         else
         {
@@ -480,9 +709,13 @@ static void ma_gui_visu_vumeter(bool init, uint8_t type)
     /* get RMS levels */
     levels = ma_audio_last_levels();
 
-    /* run filters */
-    low_pass_filter((uint8_t)levels->left, &lrms_filter);
-    low_pass_filter((uint8_t)levels->right, &rrms_filter);
+    /* measure the real frame interval: the loop speed changes with the display traffic */
+    frame_interval = g_timestamp - frame_timestamp;
+    frame_timestamp += frame_interval;
+
+    /* run the ballistics */
+    ballistics_process((uint8_t)levels->left, frame_interval, &lrms_ballistics);
+    ballistics_process((uint8_t)levels->right, frame_interval, &rrms_ballistics);
 
     pause++;
     if ((type == (uint8_t)METER_VU_LINES_HORIZ) )
@@ -498,7 +731,7 @@ static void ma_gui_visu_vumeter(bool init, uint8_t type)
         else if (left_or_right == 1U && (pause >= 10))
         {
             display_load_bars_horiz(true);
-            disp_left = voltage_to_display_dB((uint8_t)lrms_filter.output, 50U);
+            disp_left = voltage_to_display_dB((uint8_t)lrms_ballistics.output, DBSCALE_LEVELS_50);
             left_or_right++;
             pause=0;
         }
@@ -512,7 +745,7 @@ static void ma_gui_visu_vumeter(bool init, uint8_t type)
         else if (left_or_right == 3U && (pause >= 10))
         {
             display_load_bars_horiz(false);
-            disp_left = voltage_to_display_dB((uint8_t)rrms_filter.output, 50U);
+            disp_left = voltage_to_display_dB((uint8_t)rrms_ballistics.output, DBSCALE_LEVELS_50);
             left_or_right = 0U;
             pause=0;
         }
@@ -529,8 +762,8 @@ static void ma_gui_visu_vumeter(bool init, uint8_t type)
         display_clean();
         display_set_cursor(0,0);
 
-        disp_right = voltage_to_display_dB((uint8_t)rrms_filter.output, 10U);
-        disp_left = voltage_to_display_dB((uint8_t)lrms_filter.output, 10U);
+        disp_right = voltage_to_display_dB((uint8_t)rrms_ballistics.output, DBSCALE_LEVELS_10);
+        disp_left = voltage_to_display_dB((uint8_t)lrms_ballistics.output, DBSCALE_LEVELS_10);
 
         display_show_vumeter_harrows(disp_left,disp_right);
     }
@@ -542,17 +775,53 @@ static void ma_gui_visu_vumeter(bool init, uint8_t type)
 
         spektrum = ma_audio_spectrum(&fft_n);
 
-        /* remove the DC component */
-        spektrum[0] = 0;
-        for (i = 0; i < (FFT_N/2/3); i++)
+        peaks_fall = ((g_timestamp - fft_peaks_timestamp) >= FFT_PEAK_FALL_US);
+        if (peaks_fall == true) fft_peaks_timestamp = g_timestamp;
+
+        for (i = 0; i < FFT_BARS; i++)
         {
-            /* sum up the frequencies in group by 3 */
-            v = ((uint8_t)spektrum[i*3] + (uint8_t)spektrum[i*3+1] + (uint8_t)spektrum[i*3+2]);
+            /* 1 or 2 bins per bar, from bin 1 (no DC), scaled to 3 bins */
+            bin = 1U + ((i * 3U) >> 1);
+            if ((1U + (((i + 1U) * 3U) >> 1)) - bin == 1U)
+            {
+                sum = spektrum[bin] * 3U;
+            }
+            else
+            {
+                sum = spektrum[bin] + spektrum[bin + 1U];
+                sum += sum >> 1;
+            }
             /* convert to the display scale */
-            disp_left = voltage_to_display_dB(v, 7U);
-            /* draw the bar */
-            display_show_vertical_bar(disp_left);
+            v = voltage_to_display_dB((sum > 0xFFU) ? 0xFFU : (uint8_t)sum, DBSCALE_LEVELS_7);
+            bars[i] = (v > GLYPH_ROWS) ? GLYPH_ROWS : v;
+
+            /* the peak dots fall a row at a time */
+            if (bars[i] >= fft_peaks[i]) fft_peaks[i] = bars[i];
+            else if (peaks_fall == true) fft_peaks[i]--;
         }
+
+        display_show_bars(bars, fft_peaks, FFT_BARS);
+    }
+    else if (type == METER_LOUDNESS)
+    {
+        /* "M-23  S-24": momentary and short-term loudness */
+        ma_loudness_levels(&momentary, &short_term);
+
+        display_clean();
+        display_set_cursor(0,0);
+        display_write_char('M');
+        ma_gui_write_lu(momentary);
+        display_set_cursor(0,6);
+        display_write_char('S');
+        ma_gui_write_lu(short_term);
+    }
+    else if (type == METER_CORRELATION)
+    {
+        /* -1..+1 mapped to -25..+25 columns (25/127 ~ 51/256) */
+        corr = ma_audio_correlation();
+        corr_columns = (int8_t)((((corr < 0) ? -corr : corr) * 51) >> 8);
+        display_set_cursor(0,0);
+        display_show_correlation_bar((corr < 0) ? -corr_columns : corr_columns);
     }
     else
     {
@@ -564,20 +833,15 @@ static void ma_gui_refresh(bool refreshed, bool flag50ms)
 {
 
     static bool init = false;
-    static uint8_t end;
+    t_display_frames *frames;
+    uint32_t frame_value;
 
     if (ma_gui_get_page_active() == &PAGE_SOURCE)
     {
         if (refreshed == true)
         {
             init = false;
-            end = 0U;
         }
-//        else if (end < FLAG_1000MS_50MS_UNITS)
-//        {
-///            /* wait: increment only when 50ms flag is active */
-//            end += flag50ms ? 1U : 0U;
-//        }
         else
         {
             ma_gui_visu_vumeter(init, persistent.meter_type);
@@ -585,6 +849,116 @@ static void ma_gui_refresh(bool refreshed, bool flag50ms)
             init = true;
         }
     }
+    else if (ma_gui_get_page_active() == &PAGE_DEBUG)
+    {
+        if ((flag50ms == true) && (debug_view < SOURCE_MAX))
+        {
+            /* "RADIO 9999": clip events of the source */
+            display_clean();
+            display_set_cursor(0,0);
+            display_write_string(g_string_table[MENU_SOURCE[debug_view].label]);
+            display_set_cursor(0,6);
+            display_write_unsigned(clip.counters[debug_view], 0U, DEBUG_VALUE_FORMAT, NULL);
+        }
+        else if ((flag50ms == true) && (debug_view <= DEBUG_VIEW_LAST))
+        {
+            /* "Frame 1200" (longest flush, us), "Drops   12", "Cycle  800" (us),
+             * "Bus    640" (bytes per second) or "Wait   150" (us per second) */
+            frames = display_frame_stats();
+            if (debug_view == DEBUG_VIEW_FRAME)
+            {
+                frame_value = frames->time_max;
+            }
+            else if (debug_view == DEBUG_VIEW_DROPS)
+            {
+                frame_value = frames->dropped;
+            }
+#ifdef DEASPLAY_BUS_STATS
+            else if (debug_view == DEBUG_VIEW_BUS)
+            {
+                frame_value = display_bus_stats()->second.bits >> 3;
+            }
+            else if (debug_view == DEBUG_VIEW_WAIT)
+            {
+                frame_value = display_bus_stats()->second.busy;
+            }
+#endif
+            else
+            {
+                frame_value = operational.cycle_time;
+            }
+            display_clean();
+            display_set_cursor(0,0);
+            display_write_string(g_string_table[MENU_DEBUG[debug_view].label]);
+            display_set_cursor(0,6);
+            display_write_unsigned((frame_value > DEBUG_VALUE_MAX) ? DEBUG_VALUE_MAX : (uint16_t)frame_value, 0U, DEBUG_VALUE_FORMAT, NULL);
+        }
+    }
+    else if (ma_gui_get_page_active() == &PAGE_STATISTICS)
+    {
+        if ((flag50ms == true) && (stats_view < SOURCE_MAX))
+        {
+            /* rotate the fields every second */
+            stats_ticks++;
+            if (stats_ticks >= FLAG_1000MS_50MS_UNITS)
+            {
+                stats_ticks = 0U;
+                stats_field++;
+                if (stats_field > sizeof(STATS_LABELS))
+                {
+                    stats_field = 0U;
+                }
+                ma_gui_visu_stats(stats_view, stats_field);
+            }
+        }
+    }
+}
+
+/**
+* clip_processing
+*
+* @brief Count the clip events of the current source and drive the
+*        clip indicator: the clipped half of the display blinks (in
+*        hardware when possible) until CLIP_HOLD_US after the last clip.
+*/
+static void clip_processing(void)
+{
+
+    uint8_t flags;
+
+    flags = ma_audio_clip_flags();
+
+    if (flags != 0U)
+    {
+        if ((persistent.audio_source < SOURCE_MAX) && (clip.counters[persistent.audio_source] < CLIP_COUNTER_MAX))
+        {
+            clip.counters[persistent.audio_source]++;
+        }
+        clip.timestamp = g_timestamp;
+
+        if ((clip.latched | flags) != clip.latched)
+        {
+            /* a new channel clipped: latch it */
+            clip.latched |= flags;
+            if ((flags & MA_AUDIO_CLIP_LEFT) != 0U) display_blink(0, 0, CLIP_HALF, CLIP_BLINK_MS);
+            if ((flags & MA_AUDIO_CLIP_RIGHT) != 0U) display_blink(0, CLIP_HALF, DEASPLAY_CHARS - CLIP_HALF, CLIP_BLINK_MS);
+        }
+        else
+        {
+            /* already latched */
+        }
+    }
+    else if ((clip.latched != 0U) && ((g_timestamp - clip.timestamp) > CLIP_HOLD_US))
+    {
+        /* release the indicator */
+        clip.latched = 0U;
+        display_blink(0, 0, DEASPLAY_CHARS, 0U);
+    }
+    else
+    {
+        /* nothing to do */
+    }
+
 }
 
 /**
@@ -595,11 +969,16 @@ static void ma_gui_refresh(bool refreshed, bool flag50ms)
 static void set_display_brightness(uint8_t level)
 {
 
+#ifdef DEASPLAY_LC75710
     static uint8_t brightness_levels[5] = { 48, 96, 144, 192, 240 };
+#endif
 
     if (level < 5)
     {
+#ifdef DEASPLAY_LC75710
+        /* the other displays have no dimming */
         lc75710_intensity(brightness_levels[level]);
+#endif
         persistent.brightness = level;
         write_to_persistent(&persistent);
     }
@@ -617,6 +996,8 @@ static void persistent_defaults(t_persistent* persistent)
 {
     persistent->brightness = 0;
     persistent->audio_source = 0;
+    persistent->meter_type = METER_VU_LINES_HORIZ;
+    persistent->ballistics = 0;
 }
 
 static void io_init()
@@ -660,11 +1041,17 @@ void setup()
     /* Load persistent data */
     read_from_persistent(&persistent);
 
+    /* Source statistics */
+    ma_stats_init(g_timestamp);
+
     /* Validate settings */
-    if (persistent.meter_type > METER_TOTAL_METERS)
+    if (persistent.meter_type >= METER_TOTAL_METERS)
     {
-        persistent.meter_type = METER_VU_LINES_HORIZ;
+        /* blank (0xFF) or corrupted EEPROM */
+        persistent_defaults(&persistent);
     }
+    /* a blank EEPROM (0xFF) would set PPM everywhere: only the level meters have a bit */
+    persistent.ballistics &= (uint8_t)((1U << METER_VU_LINES_HORIZ) | (1U << METER_VU_HARROW_HORIZ));
 
     /* Initialize the GUI */
     ma_gui_init(&PAGE_SOURCE);
@@ -729,7 +1116,9 @@ int main(void)
 {
 
     uint32_t start;
-    bool refreshed;
+    bool refreshed = true;     /* the first page has just been drawn */
+    t_audio_voltage* levels;
+    uint16_t level;
 
     /* Disable interrupts for the whole init period */
     cli();
@@ -778,7 +1167,17 @@ int main(void)
         keypad_periodic(operational.flag_10ms.flag);
 
         /* Process audio (FFT / VU-METER) */
-        ma_audio_process();
+        if (ma_audio_process() == true)
+        {
+            /* new levels: source statistics */
+            levels = ma_audio_last_levels();
+            level = (levels->left + levels->right) >> 1U;
+            ma_stats_update(persistent.audio_source, (level > 0xFFU) ? 0xFFU : (uint8_t)level, g_timestamp);
+        }
+        ma_stats_periodic();
+
+        /* Clip indicator and counters */
+        clip_processing();
 
         /* Run the periodic menu refresh handler */
         ma_gui_refresh(refreshed, operational.flag_50ms.flag);
@@ -789,8 +1188,8 @@ int main(void)
         /* Set outputs */
         output(&operational.output);
 
-        /* Display Refresh */
-        display_periodic();
+        /* Display Refresh: fixed frame rate, a waiting audio block goes first */
+        display_frame_periodic(ma_audio_pending());
 
         /* Cycle end */
         operational.cycle_time = g_timestamp - start;
@@ -47,7 +47,9 @@ ISR(BADISR_vect)
 
 void system_fatal(char *str)
 {
-    display_string(str);
+    display_write_string(str);
+    /* nothing else runs from here: flush it now */
+    display_periodic();
     for(;;);
 }
 
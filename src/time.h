@@ -29,7 +29,7 @@
 #ifndef SRC_TIME_H_
 #define SRC_TIME_H_
 
-extern uint32_t g_timestamp;    /**< Time-keeping in us. Resolution is 100us TICK */
+extern volatile uint32_t g_timestamp;    /**< Time-keeping in us. Resolution is 100us TICK */
 
 void timer_init(void);
 
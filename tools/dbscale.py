@@ -0,0 +1,179 @@
+
+import sys
+
+# Reference voltage-to-dB scale: the RMS value (ADC units) at which each
+# of the 50 display steps lights up, from 0 dB down to the noise floor.
+# Every supported display resolution is a sub-sampling of this table.
+DB_SCALE = [
+    150, 136, 122, 110, 100,  90,  81,  73,  66,  60,
+     54,  48,  44,  40,  36,  32,  29,  26,  24,  21,
+     19,  18,  16,  14,  13,  12,  11,  10,   9,   8,
+      7,   7,   6,   5,   5,   4,   4,   4,   3,   3,
+      3,   3,   2,   2,   2,   2,   2,   2,   2,   1,
+      1
+]
+
+DB_SCALE_STEPS = len(DB_SCALE) - 1
+
+DEFINE_TEMPLATE = \
+'''#define DBSCALE_LEVELS_%i%s%iU    /**< %i levels display scale */
+'''
+
+HEADER_TEMPLATE = \
+'''
+/*
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+    Lorenzo Miori (C) 2015-2016 [ 3M4|L: memoryS60<at>gmail.com ]
+
+    Version History
+        * 1.0 initial
+
+*/
+
+/**
+ * @file PLACEHOLDER_FILENAME.h
+ * @author Lorenzo Miori
+ * @date Oct 2016
+ * @brief Header file for the voltage to dB display scales (generated by tools/dbscale.py)
+ */
+
+#ifndef SRC_DBSCALE_H_
+#define SRC_DBSCALE_H_
+
+#include <stdint.h>
+#include <avr/pgmspace.h>
+
+/** Describes one display scale inside the threshold table */
+typedef struct
+{
+    uint8_t levels;     /**< Display resolution (levels) */
+    uint8_t offset;     /**< First threshold in g_dbscale_thresholds */
+} t_dbscale;
+
+/* Scale identifiers (index into g_dbscale_tables) */
+PLACEHOLDER_DEFINES
+#define DBSCALE_NUM_SCALES  PLACEHOLDER_NUMU
+
+extern const t_dbscale g_dbscale_tables[] PROGMEM;    /**< Scale descriptors (flash) */
+extern const uint8_t g_dbscale_thresholds[] PROGMEM;  /**< Ascending thresholds (flash) */
+
+#endif  /* SRC_DBSCALE_H_ */
+'''
+
+SOURCE_TEMPLATE = \
+'''
+/*
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+    Lorenzo Miori (C) 2015-2016 [ 3M4|L: memoryS60<at>gmail.com ]
+
+    Version History
+        * 1.0 initial
+
+*/
+
+/**
+ * @file PLACEHOLDER_FILENAME.c
+ * @author Lorenzo Miori
+ * @date Oct 2016
+ * @brief Voltage to dB display scales (generated by tools/dbscale.py)
+ */
+
+#include "PLACEHOLDER_FILENAME.h"
+
+/* SCALE TABLES SIZE XXXBYTESXXX BYTES */
+const t_dbscale g_dbscale_tables[] PROGMEM =
+{
+PLACEHOLDER_TABLES
+};
+
+const uint8_t g_dbscale_thresholds[] PROGMEM =
+{
+PLACEHOLDER_THRESHOLDS
+};
+'''
+
+def scale(levels):
+
+    # Thresholds are stored ascending: the display level is then
+    # the number of thresholds lower than or equal to the input
+    step = DB_SCALE_STEPS // levels
+    return sorted([DB_SCALE[i * step] for i in range(levels + 1)])
+
+def convert(resolutions):
+
+    defines = ""
+    tables = ""
+    thresholds = ""
+    offset = 0
+
+    for index, levels in enumerate(resolutions):
+        if levels < 1 or levels > DB_SCALE_STEPS:
+            print("Unsupported resolution: %i" % levels)
+            sys.exit(1)
+        values = scale(levels)
+        defines += DEFINE_TEMPLATE % (levels, " " * (8 - len(str(levels))), index, levels)
+        tables += "    { .levels = %2iU, .offset = %3iU },\n" % (levels, offset)
+        thresholds += "    /* %i levels */\n" % levels
+        for row in range(0, len(values), 10):
+            thresholds += "    %s,\n" % ", ".join(["%3i" % v for v in values[row:row + 10]])
+        offset += len(values)
+
+    if offset > 0xFF:
+        print("Threshold table too big (%i bytes)" % offset)
+        sys.exit(1)
+
+    size = offset + 2 * len(resolutions)
+    print("Scale tables use %i bytes" % size)
+
+    return defines.rstrip("\n"), tables.rstrip("\n"), thresholds.rstrip("\n"), size
+
+def create_header(filename, defines, num):
+
+    fo = open("%s.h" % filename, "w")
+    fo.write(HEADER_TEMPLATE.replace("PLACEHOLDER_FILENAME", filename)
+                            .replace("PLACEHOLDER_DEFINES", defines)
+                            .replace("PLACEHOLDER_NUM", "%i" % num))
+    fo.close()
+
+def create_source(filename, tables, thresholds, size):
+
+    fo = open("%s.c" % filename, "w")
+    fo.write(SOURCE_TEMPLATE.replace("PLACEHOLDER_FILENAME", filename)
+                            .replace("PLACEHOLDER_TABLES", tables)
+                            .replace("PLACEHOLDER_THRESHOLDS", thresholds)
+                            .replace("XXXBYTESXXX", "%i" % size))
+    fo.close()
+
+if len(sys.argv) < 3:
+    print("Usage: dbscale.py <output name> <levels> [<levels> ...]")
+    sys.exit(1)
+else:
+    fn = sys.argv[1]
+    resolutions = [int(x) for x in sys.argv[2:]]
+    defines, tables, thresholds, size = convert(resolutions)
+    create_header(fn, defines, len(resolutions))
+    create_source(fn, tables, thresholds, size)
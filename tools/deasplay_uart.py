@@ -0,0 +1,127 @@
+
+import sys
+
+# Terminal decoder for the DEASPLAY_UART display backend
+# (see src/deasplay/driver/UART/uart_hal.h for the protocol).
+#
+# Usage: deasplay_uart.py <serial port | file | -> [baud] [record file]
+#
+# Reads from a serial port (needs pyserial), a recorded stream or stdin,
+# and redraws the display in the terminal at every refresh marker.
+
+OP_RUN = 0x20
+OP_GLYPH = 0x40
+OP_FRAME = 0x60
+OP_POWER = 0x80
+OP_CURSOR = 0xA0
+OP_HELLO = 0xC0
+
+GLYPH_ROWS = 7
+GLYPH_SLOTS = 32
+
+# Custom glyphs are drawn with a shade matching their lit dots
+SHADES = [" ", "░", "▒", "▓", "█"]
+
+class Display:
+
+    def __init__(self):
+        self.reset(1, 10)
+        self.frames = 0
+        self.lost = 0
+        self.sequence = None
+
+    def reset(self, lines, chars):
+        self.lines = lines
+        self.chars = chars
+        self.cells = [[0x20] * chars for _ in range(lines)]
+        self.glyphs = {}
+        self.power = True
+
+    def shade(self, code):
+        rows = self.glyphs.get(code, [0] * GLYPH_ROWS)
+        dots = sum(bin(r & 0x1F).count("1") for r in rows)
+        return SHADES[(dots * (len(SHADES) - 1) + 34) // 35]
+
+    def cell(self, code):
+        if code in self.glyphs:
+            return self.shade(code)
+        if 0x20 <= code < 0x7F:
+            return chr(code)
+        return "?"
+
+    def render(self, out):
+        out.write("\x1b[H")
+        for line in self.cells:
+            text = "".join(self.cell(c) for c in line) if self.power else " " * self.chars
+            out.write("|" + text + "|\x1b[K\n")
+        out.write("frames %i  lost %i\x1b[K\n" % (self.frames, self.lost))
+        out.flush()
+
+    def frame(self, sequence):
+        if self.sequence is not None:
+            self.lost += (sequence - self.sequence - 1) % 32
+        self.sequence = sequence
+        self.frames += 1
+
+def decode(stream, display, out, record=None):
+
+    def read(n):
+        data = stream.read(n)
+        if record is not None and data:
+            record.write(data)
+        if len(data) < n:
+            raise EOFError
+        return bytearray(data)
+
+    out.write("\x1b[2J")
+    while True:
+        command = read(1)[0]
+        op = command & 0xE0
+        arg = command & 0x1F
+        if op == OP_RUN:
+            pos = read(1)[0]
+            line, chr_ = pos >> 5, pos & 0x1F
+            for c in read(arg + 1):
+                if line < display.lines and chr_ < display.chars:
+                    display.cells[line][chr_] = c
+                chr_ += 1
+        elif op == OP_GLYPH:
+            display.glyphs[arg] = list(read(GLYPH_ROWS))
+        elif op == OP_FRAME:
+            display.frame(arg)
+            display.render(out)
+        elif op == OP_POWER:
+            display.power = (arg & 0x1) == 1
+        elif op == OP_CURSOR:
+            pass
+        elif op == OP_HELLO:
+            geometry = read(2)
+            display.reset(geometry[0], geometry[1])
+            out.write("\x1b[2J")
+        else:
+            # not a command: out of sync, skip it
+            pass
+
+def open_input(name, baud):
+
+    if name == "-":
+        return sys.stdin.buffer if hasattr(sys.stdin, "buffer") else sys.stdin
+    if name.startswith("/dev/") or name.upper().startswith("COM"):
+        import serial
+        return serial.Serial(name, baud)
+    return open(name, "rb")
+
+if len(sys.argv) < 2:
+    print("Usage: deasplay_uart.py <serial port | file | -> [baud] [record file]")
+    sys.exit(1)
+else:
+    baud = int(sys.argv[2]) if len(sys.argv) > 2 else 38400
+    record = open(sys.argv[3], "wb") if len(sys.argv) > 3 else None
+    display = Display()
+    try:
+        decode(open_input(sys.argv[1], baud), display, sys.stdout, record)
+    except (EOFError, KeyboardInterrupt):
+        pass
+    finally:
+        if record is not None:
+            record.close()
@@ -0,0 +1,182 @@
+
+import sys
+
+# Converts the glyph drawings of glyphs.txt into flash tables: every
+# glyph becomes 7 bytes, one per row (top first), bit 0 the left column.
+# The firmware copies them to the display without any bit shuffling.
+
+GLYPH_ROWS = 7
+GLYPH_COLUMNS = 5
+
+DEFINE_TEMPLATE = \
+'''#define GLYPH_%s%s%3iU    /**< %i glyphs, %s */
+'''
+
+HEADER_TEMPLATE = \
+'''
+/*
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+    Lorenzo Miori (C) 2015-2016 [ 3M4|L: memoryS60<at>gmail.com ]
+
+    Version History
+        * 1.0 initial
+
+*/
+
+/**
+ * @file PLACEHOLDER_FILENAME.h
+ * @author Lorenzo Miori
+ * @date Oct 2016
+ * @brief Header file for the custom glyph bitmaps (generated by tools/glyphCify.py)
+ */
+
+#ifndef SRC_GLYPHS_H_
+#define SRC_GLYPHS_H_
+
+#include <stdint.h>
+#include <avr/pgmspace.h>
+
+#define GLYPH_ROWS              PLACEHOLDER_ROWSU    /**< Bytes per glyph: a row each, top first, bit 0 on the left */
+
+/* Glyph families (index of their first glyph in g_glyph_table) */
+PLACEHOLDER_DEFINES
+#define GLYPH_NUM_IDS          PLACEHOLDER_NUMU
+
+extern const uint8_t g_glyph_table[][GLYPH_ROWS] PROGMEM;   /**< Glyph bitmaps (flash) */
+
+#endif  /* SRC_GLYPHS_H_ */
+'''
+
+SOURCE_TEMPLATE = \
+'''
+/*
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+    Lorenzo Miori (C) 2015-2016 [ 3M4|L: memoryS60<at>gmail.com ]
+
+    Version History
+        * 1.0 initial
+
+*/
+
+/**
+ * @file PLACEHOLDER_FILENAME.c
+ * @author Lorenzo Miori
+ * @date Oct 2016
+ * @brief Custom glyph bitmaps (generated by tools/glyphCify.py)
+ */
+
+#include "PLACEHOLDER_FILENAME.h"
+
+/* GLYPH TABLE SIZE XXXBYTESXXX BYTES */
+const uint8_t g_glyph_table[][GLYPH_ROWS] PROGMEM =
+{
+PLACEHOLDER_TABLE
+};
+'''
+
+def parse(filename):
+
+    families = []
+    family = None
+
+    fs = open(filename, "r")
+    for number, line in enumerate(fs.readlines()):
+        line = line.rstrip()
+        if line == "" or line.startswith(";"):
+            continue
+        if family is None or len(family[2]) == GLYPH_ROWS:
+            # a new family: name and description
+            name, _, doc = line.partition(" ")
+            family = (name, doc.strip(), [])
+            families.append(family)
+        else:
+            cells = line.split()
+            if any(len(c) != GLYPH_COLUMNS or c.strip(".#") != "" for c in cells) or \
+               (len(family[2]) > 0 and len(cells) != len(family[2][0])):
+                print("%s:%i: bad glyph row" % (filename, number + 1))
+                sys.exit(1)
+            family[2].append(cells)
+    fs.close()
+
+    if family is not None and len(family[2]) != GLYPH_ROWS:
+        print("%s: %s has %i rows" % (filename, family[0], len(family[2])))
+        sys.exit(1)
+
+    return families
+
+def row_value(cell):
+
+    # bit 0 is the left column
+    return sum(1 << i for i, c in enumerate(cell) if c == "#")
+
+def convert(families):
+
+    defines = ""
+    table = ""
+    index = 0
+
+    for name, doc, rows in families:
+        count = len(rows[0])
+        defines += DEFINE_TEMPLATE % (name, " " * (16 - len(name)), index, count, doc)
+        table += "    /* %s */\n" % name
+        for g in range(count):
+            table += "    { %s },\n" % ", ".join(["0x%02X" % row_value(rows[r][g]) for r in range(GLYPH_ROWS)])
+        index += count
+
+    if index > 0xFF:
+        print("Too many glyphs (%i)" % index)
+        sys.exit(1)
+
+    size = index * GLYPH_ROWS
+    print("Glyphs use %i bytes" % size)
+
+    return defines.rstrip("\n"), table.rstrip("\n"), index, size
+
+def create_header(filename, defines, num):
+
+    fo = open("%s.h" % filename, "w")
+    fo.write(HEADER_TEMPLATE.replace("PLACEHOLDER_FILENAME", filename)
+                            .replace("PLACEHOLDER_DEFINES", defines)
+                            .replace("PLACEHOLDER_ROWS", "%i" % GLYPH_ROWS)
+                            .replace("PLACEHOLDER_NUM", "%i" % num))
+    fo.close()
+
+def create_source(filename, table, size):
+
+    fo = open("%s.c" % filename, "w")
+    fo.write(SOURCE_TEMPLATE.replace("PLACEHOLDER_FILENAME", filename)
+                            .replace("PLACEHOLDER_TABLE", table)
+                            .replace("XXXBYTESXXX", "%i" % size))
+    fo.close()
+
+if len(sys.argv) < 3:
+    print("Usage: glyphCify.py <glyph file> <output name>")
+    sys.exit(1)
+else:
+    defines, table, num, size = convert(parse(sys.argv[1]))
+    create_header(sys.argv[2], defines, num)
+    create_source(sys.argv[2], table, size)
@@ -2,3 +2,9 @@
 # prepare string source code files
 
 python strinCify.py strings.txt ma_strings && mv ma_strings.* ../src/
+
+# prepare the voltage to dB display scales (50, 10 and 7 levels)
+python dbscale.py ma_dbscale 50 10 7 && mv ma_dbscale.* ../src/
+
+# prepare the custom glyph bitmaps
+python glyphCify.py glyphs.txt ma_glyphs && mv ma_glyphs.* ../src/